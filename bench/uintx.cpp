@@ -0,0 +1,162 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+// Measures the cost of uintx operations across operand sizes. Every
+// operation is repeated until it has run for the minimum time and the
+// average time and number of heap allocations per call are reported.
+//
+// usage: bench [max limbs] [minimum milliseconds per measurement]
+
+#include <gears/math.hpp>
+#include <gears/math/algorithm.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+size_t allocations = 0;
+
+// kept out of line so the compiler does not pair the free with new
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noinline))
+#endif
+void release(void* pointer) noexcept {
+    std::free(pointer);
+}
+} // anonymous
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if(void* result = std::malloc(size == 0 ? 1 : size)) {
+        return result;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    release(pointer);
+}
+
+namespace {
+using integer = gears::math::uintx<>;
+constexpr size_t limb_bits = 32;
+
+// keeps results observable so the work is not optimised away
+volatile size_t sink = 0;
+std::mt19937 engine(12345);
+
+integer random_integer(size_t limbs) {
+    std::uniform_int_distribution<int> digit(0, 15);
+    std::string hex(limbs * limb_bits / 4, '0');
+    for(auto&& c : hex) {
+        c = "0123456789abcdef"[digit(engine)];
+    }
+    hex[0] = 'f';
+    return integer(hex, 16);
+}
+
+struct result {
+    double nanoseconds;
+    double allocations;
+};
+
+template<typename Function>
+result measure(Function f, double minimum) {
+    using clock = std::chrono::steady_clock;
+    size_t iterations = 0;
+    const size_t before = allocations;
+    const auto start = clock::now();
+    double elapsed = 0;
+
+    do {
+        f();
+        ++iterations;
+        elapsed = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    }
+    while(elapsed < minimum);
+
+    return { elapsed * 1e6 / iterations, static_cast<double>(allocations - before) / iterations };
+}
+
+void report(const char* name, size_t limbs, result r) {
+    std::printf("%-12s %8zu %16.1f %12.2f\n", name, limbs, r.nanoseconds, r.allocations);
+    std::fflush(stdout);
+}
+} // anonymous
+
+int main(int argc, char** argv) {
+    const size_t max_limbs = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const double minimum = argc > 2 ? std::strtod(argv[2], nullptr) : 50.0;
+    const size_t sizes[] = { 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 4096, 16384, 65536, 100000 };
+
+    std::printf("%-12s %8s %16s %12s\n", "operation", "limbs", "ns/op", "allocs/op");
+    for(size_t limbs : sizes) {
+        if(limbs > max_limbs) {
+            break;
+        }
+
+        const integer a = random_integer(limbs);
+        const integer b = random_integer(limbs);
+        const integer wide = random_integer(2 * limbs);
+        const integer small = random_integer(limbs > 1 ? limbs / 2 : 1);
+        const std::string decimal = gears::math::uintx_cast<std::string>(a);
+
+        report("add", limbs, measure([&] { sink = sink + (a + b ? 1 : 0); }, minimum));
+        report("sub", limbs, measure([&] { sink = sink + (a - small ? 1 : 0); }, minimum));
+        report("add_mul", limbs, measure([&] { integer c = a; gears::math::add_mul(c, b, integer(12345)); sink = sink + (c ? 1 : 0); }, minimum));
+        report("mul", limbs, measure([&] { sink = sink + (a * b ? 1 : 0); }, minimum));
+        report("sqr", limbs, measure([&] { sink = sink + (a * a ? 1 : 0); }, minimum));
+        report("div", limbs, measure([&] { sink = sink + (wide / a ? 1 : 0); }, minimum));
+        report("mod", limbs, measure([&] { sink = sink + (wide % a ? 1 : 0); }, minimum));
+        report("divmod", limbs, measure([&] { sink = sink + (gears::math::divmod(wide, a).first ? 1 : 0); }, minimum));
+        report("shift", limbs, measure([&] { sink = sink + ((a << 77) ? 1 : 0); }, minimum));
+        report("to_string", limbs, measure([&] { sink = sink + gears::math::uintx_cast<std::string>(a).size(); }, minimum));
+        report("from_string", limbs, measure([&] { sink = sink + (integer(decimal) ? 1 : 0); }, minimum));
+        report("cast<ull>", limbs, measure([&] { sink = sink + gears::math::uintx_cast<unsigned long long>(a); }, minimum));
+        report("cast<double>", limbs, measure([&] { sink = sink + (gears::math::uintx_cast<double>(a) > 0 ? 1 : 0); }, minimum));
+
+        if(limbs <= 256) {
+            const integer modulus = a | 1;
+            report("mod_pow", limbs, measure([&] { sink = sink + (gears::math::mod_pow(b, small, modulus) ? 1 : 0); }, minimum));
+        }
+    }
+}
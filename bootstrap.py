@@ -55,12 +55,17 @@ if args.debug:
 else:
     cxxflags.extend(['-DNDEBUG', '-O3'])
 
+# the parallel prime sieve runs on std::thread
+if sys.platform != 'win32':
+    cxxflags.append('-pthread')
+
 if args.cxx == 'clang++':
     ignored_warnings.extend(['constexpr-not-const', 'unused-value'])
 
 builddir = 'bin'
 objdir = 'obj'
 tests = os.path.join(builddir, 'tests')
+benchmarks = os.path.join(builddir, 'bench')
 
 # utilities
 def flags(*args):
@@ -101,6 +106,7 @@ ninja.rule('compile', command = '$cxx -MMD -MF $out.d -c $cxxflags $in -o $out',
                       description = 'Compiling $in to $out')
 ninja.rule('link', command = '$cxx $cxxflags $in -o $out', description = 'Creating $out')
 ninja.rule('runner', command = tests)
+ninja.rule('benchmark', command = benchmarks)
 
 if doxygen_path:
     ninja.rule('documentation', command = '{} $in'.format(doxygen_path), description = 'Generating documentation')
@@ -118,6 +124,16 @@ for f in source_files:
 
 ninja.build(tests, 'link', inputs = object_files)
 ninja.build('tests', 'phony', inputs = tests)
+
+bench_files = list(get_files('bench', '*.cpp'))
+bench_objects = [object_file(f) for f in bench_files]
+for f in bench_files:
+    ninja.build(object_file(f), 'compile', inputs = f)
+
+ninja.build(benchmarks, 'link', inputs = bench_objects)
+ninja.build('run_bench', 'benchmark', implicit = benchmarks)
+ninja.build('bench', 'phony', inputs = 'run_bench')
+
 ninja.build('install', 'installer', inputs = args.install_dir)
 ninja.build('uninstall', 'uninstaller')
 ninja.build('run', 'runner', implicit = 'tests')
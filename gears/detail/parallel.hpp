@@ -0,0 +1,81 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef GEARS_DETAIL_PARALLEL_HPP
+#define GEARS_DETAIL_PARALLEL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace gears {
+namespace detail {
+// 0 means one thread per hardware thread
+inline unsigned thread_count(unsigned threads) noexcept {
+    if(threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    return threads == 0 ? 1 : threads;
+}
+
+// chunks of at least minimum long, a few per thread so that threads
+// finishing early can take more
+inline size_t chunk_count(unsigned long long range, unsigned long long minimum, unsigned threads) noexcept {
+    const unsigned long long most = 8ULL * threads;
+    const unsigned long long fit = range / minimum;
+    return static_cast<size_t>(fit == 0 ? 1 : fit < most ? fit : most);
+}
+
+// Splits [first, last) into at most chunks chunks whose length is a multiple
+// of unit, except for the last, and calls f(begin, end, index) for each of
+// them. The chunks are handed out in order to the requested number of
+// threads, the calling thread being one of them. Exceptions thrown by f are
+// rethrown.
+template<typename Function>
+inline void parallel_chunks(unsigned long long first, unsigned long long last, size_t chunks, unsigned threads, Function f, unsigned long long unit = 1) {
+    const unsigned long long range = last - first;
+    const unsigned long long width = (range / chunks + (range % chunks != 0) + unit - 1) / unit * unit;
+    const size_t used = width == 0 ? 1 : static_cast<size_t>(range / width + (range % width != 0));
+    std::atomic<size_t> next(0);
+
+    auto work = [&] {
+        for(size_t index = next++; index < used; index = next++) {
+            const unsigned long long begin = first + index * width;
+            f(begin, last - begin < width ? last : begin + width, index);
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    for(unsigned i = 1; i < threads && i < used; ++i) {
+        workers.push_back(std::async(std::launch::async, work));
+    }
+
+    work();
+    for(auto&& worker : workers) {
+        worker.get();
+    }
+}
+} // detail
+} // gears
+
+#endif // GEARS_DETAIL_PARALLEL_HPP
@@ -23,6 +23,8 @@
 #define GEARS_MATH_HPP
 
 #include <gears/math/uintx.hpp>
+#include <gears/math/intx.hpp>
+#include <gears/math/rational.hpp>
 #include <gears/math/generator.hpp>
 #include <gears/math/constants.hpp>
 
@@ -22,16 +22,456 @@
 #ifndef GEARS_MATH_ALGORITHM_HPP
 #define GEARS_MATH_ALGORITHM_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
+#include <gears/math/modular.hpp>
+#include <gears/math/uintx/limbs.hpp>
+
+// Primes below this are removed by trial division before factorize
+// falls back to Pollard's rho and the elliptic curve method.
+#ifndef GEARS_FACTOR_TRIAL_LIMIT
+#define GEARS_FACTOR_TRIAL_LIMIT 4096
+#endif // GEARS_FACTOR_TRIAL_LIMIT
 
 namespace gears {
 namespace math {
+namespace detail {
+template<typename T>
+constexpr typename std::enable_if<std::is_signed<T>::value, typename std::make_unsigned<T>::type>::type unsigned_abs(T value) noexcept {
+    using result = typename std::make_unsigned<T>::type;
+    return value < 0 ? static_cast<result>(result(0) - static_cast<result>(value)) : static_cast<result>(value);
+}
+
+template<typename T>
+constexpr typename std::enable_if<std::is_unsigned<T>::value, T>::type unsigned_abs(T value) noexcept {
+    return value;
+}
+
+// bit length of the magnitude, so that shifting ends for negative numbers
+template<typename T>
+inline size_t integer_bits(T number, std::true_type) noexcept {
+    size_t bits = 0;
+    for(auto magnitude = unsigned_abs(number); magnitude; magnitude >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+template<typename T>
+inline size_t integer_bits(const T& number, std::false_type) {
+    return bit_length(number);
+}
+
+template<typename T>
+inline size_t integer_bits(const T& number) {
+    return integer_bits(number, std::is_integral<T>{});
+}
+
+template<typename T>
+inline T gcd(const T& x, const T& y, std::true_type) noexcept {
+    return static_cast<T>(binary_gcd(unsigned_abs(x), unsigned_abs(y)));
+}
+
+template<typename T>
+inline T gcd(T x, T y, std::false_type) {
+    while(y != 0) {
+        T remainder = x % y;
+        x = std::move(y);
+        y = std::move(remainder);
+    }
+    return x;
+}
+
+// low * (low + 1) * ... * high by binary splitting
+template<typename T>
+constexpr T range_product(const T& low, const T& high) {
+    return low == high ? low : range_product(low, T(low + (high - low) / 2)) * range_product(T(low + (high - low) / 2 + 1), high);
+}
+
+template<typename T>
+inline T integer_pow(T base, size_t exponent) {
+    T result(1);
+    while(exponent) {
+        if(exponent & 1) {
+            result *= base;
+        }
+
+        exponent >>= 1;
+        if(exponent) {
+            base *= base;
+        }
+    }
+    return result;
+}
+
+// base^k <= number, checked without any intermediate exceeding number
+template<typename T>
+inline bool power_fits(const T& base, size_t k, const T& number) {
+    const T limit = number / base;
+    T power(1);
+    for(size_t i = 0; i < k; ++i) {
+        if(limit < power) {
+            return false;
+        }
+        power *= base;
+    }
+    return true;
+}
+
+// Roots of at most 32 bits are built one bit at a time. Larger roots use
+// Newton's iteration x' = ((k - 1)x + n / x^(k - 1)) / k, which decreases
+// towards the root from any overestimate and stops on floor(n^(1/k)). The
+// start is the root of the top half of n, so only a couple of iterations
+// at full precision are needed and the recursion costs O(M(n)) in total.
+template<typename T>
+inline T iroot(const T& number, size_t k) {
+    const size_t bits = integer_bits(number);
+    if(bits == 0 || k == 1) {
+        return number;
+    }
+
+    if(k >= bits) {
+        return T(1);
+    }
+
+    if(bits / k < 32) {
+        T root(0);
+        for(size_t bit = (bits + k - 1) / k; bit > 0;) {
+            --bit;
+            T candidate(root + T(T(1) << bit));
+            if(power_fits(candidate, k, number)) {
+                root = std::move(candidate);
+            }
+        }
+        return root;
+    }
+
+    const size_t shift = bits / (2 * k);
+    T x(detail::iroot(T(number >> (k * shift)), k) + 1);
+    x = T(x << shift);
+
+    while(true) {
+        T next((x * T(k - 1) + number / integer_pow(x, k - 1)) / T(k));
+        if(!(next < x)) {
+            return x;
+        }
+        x = std::move(next);
+    }
+}
+
+// Primes tried by trial division before the probable prime tests. Any number
+// without these factors that is below the square of the last one is prime.
+constexpr unsigned small_primes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97 };
+
+// Strong probable prime test to the base for an odd modulus n > base,
+// where n - 1 = d * 2^s.
+template<typename T>
+inline bool strong_probable_prime(const modular<T>& context, const T& base, const T& d, size_t s) {
+    const T minus(context.modulus() - T(1));
+    T x(context.pow(base, d));
+    if(x == T(1) || x == minus) {
+        return true;
+    }
+
+    for(size_t r = 1; r < s; ++r) {
+        x = context.sqr(x);
+        if(x == minus) {
+            return true;
+        }
+
+        if(x == T(1)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// Miller-Rabin with witness sets that are known to have no strong
+// pseudoprimes below their bound, so the answer is exact for 64-bit numbers.
+template<typename T>
+inline bool miller_rabin(T number, const unsigned long long* bases, size_t count) {
+    const T minus(number - 1);
+    const size_t s = count_trailing_zeros(minus);
+    const T d(minus >> s);
+    const modular<T> context(number);
+    for(size_t i = 0; i < count; ++i) {
+        const T base(static_cast<T>(bases[i] % number));
+        if(base != 0 && !strong_probable_prime(context, base, d, s)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool is_prime(unsigned long long number) noexcept {
+    for(unsigned prime : small_primes) {
+        if(number % prime == 0) {
+            return number == prime;
+        }
+    }
+
+    if(number < 97 * 97) {
+        return number > 1;
+    }
+
+    // Jaeschke's bases for 32-bit numbers and Sinclair's for 64-bit ones
+    static const unsigned long long small[] = { 2, 7, 61 };
+    static const unsigned long long large[] = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+    if(number <= static_cast<unsigned>(-1)) {
+        return miller_rabin(static_cast<unsigned>(number), small, 3);
+    }
+
+    if(number < 4759123141ULL) {
+        return miller_rabin(number, small, 3);
+    }
+    return miller_rabin(number, large, 7);
+}
+
+// the low 64 bits of a number
+template<typename T>
+inline unsigned long long low_bits(const T& number) {
+    unsigned long long result = 0;
+    const size_t bits = integer_bits(number);
+    for(size_t i = 0; i < bits && i < 64; ++i) {
+        if(test_bit(number, i)) {
+            result |= 1ULL << i;
+        }
+    }
+    return result;
+}
+
+// Jacobi symbol (a/n) for odd n > a >= 0
+inline int jacobi(unsigned long long a, unsigned long long n) noexcept {
+    int result = 1;
+    while(a != 0) {
+        while(a % 2 == 0) {
+            a /= 2;
+            if(n % 8 == 3 || n % 8 == 5) {
+                result = -result;
+            }
+        }
+
+        std::swap(a, n);
+        if(a % 4 == 3 && n % 4 == 3) {
+            result = -result;
+        }
+        a %= n;
+    }
+    return n == 1 ? result : 0;
+}
+
+// Jacobi symbol (d/n) for a small odd d and a large odd n, which quadratic
+// reciprocity turns into a symbol of word sized numbers.
+template<typename T>
+inline int jacobi(long long d, const T& n) {
+    const unsigned long long k = d < 0 ? 0ULL - static_cast<unsigned long long>(d) : static_cast<unsigned long long>(d);
+    const unsigned long long mod4 = low_bits(T(n % T(4)));
+    int result = jacobi(low_bits(T(n % T(k))), k);
+    if(k % 4 == 3 && mod4 == 3) {
+        result = -result;
+    }
+    return d < 0 && mod4 == 3 ? -result : result;
+}
+
+// value modulo an odd modulus, divided by two
+template<typename T>
+inline T half_mod(const T& value, const T& modulus) {
+    return test_bit(value, 0) ? T((value >> 1) + (modulus >> 1) + T(1)) : T(value >> 1);
+}
+
+template<typename T>
+inline T signed_residue(long long value, const T& modulus) {
+    if(value >= 0) {
+        return T(static_cast<unsigned long long>(value)) % modulus;
+    }
+    const T rest(T(0ULL - static_cast<unsigned long long>(value)) % modulus);
+    return rest == T(0) ? rest : T(modulus - rest);
+}
+
+// Strong Lucas probable prime test with Selfridge's parameters: D is the
+// first of 5, -7, 9, -11, ... with (D/n) = -1, P = 1 and Q = (1 - D) / 4.
+// n must be odd, above the small primes and not a perfect square.
+template<typename T>
+inline bool strong_lucas_probable_prime(const modular<T>& context) {
+    const T& n = context.modulus();
+    long long d = 5;
+    while(true) {
+        const int symbol = jacobi(d, n);
+        if(symbol == -1) {
+            break;
+        }
+
+        // d shares a factor with n
+        if(symbol == 0) {
+            return false;
+        }
+        d = d < 0 ? 2 - d : -(d + 2);
+    }
+
+    const T dm(signed_residue(d, n));
+    const T q(signed_residue((1 - d) / 4, n));
+    const T plus(n + T(1));
+    const size_t s = countr_zero(plus);
+    const T k(plus >> s);
+
+    // U(1) = 1, V(1) = P and every step doubles the index, then adds one
+    // if the bit is set
+    T u(1);
+    T v(1);
+    T qk(q);
+    for(size_t bit = integer_bits(k) - 1; bit > 0;) {
+        --bit;
+        u = context.mul(u, v);
+        v = context.sqr(v);
+        const T twice(add_mod(qk, qk, n));
+        v = v < twice ? T(v + (n - twice)) : T(v - twice);
+        qk = context.sqr(qk);
+
+        if(test_bit(k, bit)) {
+            const T next_u(half_mod(add_mod(u, v, n), n));
+            v = half_mod(add_mod(context.mul(dm, u), v, n), n);
+            u = next_u;
+            qk = context.mul(qk, q);
+        }
+    }
+
+    if(u == T(0) || v == T(0)) {
+        return true;
+    }
+
+    for(size_t r = 1; r < s; ++r) {
+        v = context.sqr(v);
+        const T twice(add_mod(qk, qk, n));
+        v = v < twice ? T(v + (n - twice)) : T(v - twice);
+        if(v == T(0)) {
+            return true;
+        }
+        qk = context.sqr(qk);
+    }
+    return false;
+}
+
+// Baillie-PSW. No composite is known to pass it and there are none below 2^64.
+template<typename T>
+inline bool baillie_psw(const T& number) {
+    if(number < T(2)) {
+        return false;
+    }
+
+    for(unsigned prime : small_primes) {
+        if(number % T(prime) == T(0)) {
+            return number == T(prime);
+        }
+    }
+
+    if(number < T(97 * 97)) {
+        return true;
+    }
+
+    const T root(detail::iroot(number, 2));
+    if(root * root == number) {
+        return false;
+    }
+
+    const T minus(number - T(1));
+    const size_t s = countr_zero(minus);
+    const modular<T> context(number);
+    return strong_probable_prime(context, T(2), T(minus >> s), s) && strong_lucas_probable_prime(context);
+}
+
+template<typename T>
+inline bool is_prime(const T& number, std::true_type) noexcept {
+    return number > T(0) && is_prime(static_cast<unsigned long long>(number));
+}
+
+template<typename T>
+inline bool is_prime(const T& number, std::false_type) {
+    return baillie_psw(number);
+}
+} // detail
+
+/**
+ * @ingroup math
+ * @brief Calculates the integer nth root.
+ * @details Calculates `floor(number^(1/k))` exactly with Newton's method,
+ * starting from the root of the upper half of the number so that the
+ * cost is proportional to a few divisions of the full size. Works for
+ * built-in integers and `uintx`. The number must not be negative.
+ *
+ * @param number The number to take the root of.
+ * @param k The degree of the root, at least 1.
+ * @return The largest integer whose kth power is not greater than `number`.
+ */
+template<typename T>
+inline T iroot(const T& number, size_t k) {
+    return detail::iroot(number, k);
+}
+
+/**
+ * @ingroup math
+ * @brief Calculates the integer square root.
+ * @details Calculates `floor(sqrt(number))` exactly. Unlike `std::sqrt`
+ * this does not go through a `double`, so it is correct for every
+ * built-in integer and for `uintx` of any size.
+ *
+ * @param number The number to take the square root of.
+ * @return The largest integer whose square is not greater than `number`.
+ */
+template<typename T>
+inline T isqrt(const T& number) {
+    return detail::iroot(number, 2);
+}
+
+/**
+ * @ingroup math
+ * @brief Checks if a number is a perfect power.
+ * @details Checks if a number can be written as `a^b` for integers `a`
+ * and `b >= 2`. Only prime exponents up to the bit length of the number
+ * have to be tried, each with one call to `iroot`. 0 and 1 are perfect
+ * powers. The number must not be negative, negative numbers always
+ * return `false`.
+ *
+ * @param number The number to check.
+ * @return `true` if the number is a perfect power, `false` otherwise.
+ */
+template<typename T>
+inline bool is_perfect_power(const T& number) {
+    if(number < T(0)) {
+        return false;
+    }
+
+    const size_t bits = detail::integer_bits(number);
+    if(bits <= 1) {
+        return true;
+    }
+
+    for(size_t exponent = 2; exponent < bits; ++exponent) {
+        bool prime = true;
+        for(size_t d = 2; d * d <= exponent && prime; ++d) {
+            prime = exponent % d != 0;
+        }
+
+        if(prime && detail::integer_pow(detail::iroot(number, exponent), exponent) == number) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * @ingroup math
  * @brief Calculates the nth fibonacci number.
- * @details Calculates the nth fibonacci number. The internal
- * implementation does not use the naive recursion.
+ * @details Calculates the nth fibonacci number with the fast doubling
+ * identities `F(2k) = F(k)(2F(k + 1) - F(k))` and
+ * `F(2k + 1) = F(k)^2 + F(k + 1)^2`, going through the bits of `number`
+ * from the most significant one. This takes a logarithmic number of
+ * steps, so with `uintx` the cost is dominated by the last few
+ * multiplications.
  *
  * @param number Which fibonacci number to calculate.
  * @return Nth fibonacci number.
@@ -42,47 +482,139 @@ inline T fibonacci(T number) {
         return number;
     }
 
-    T a(1);
-    T b(0);
-    T c(0);
-
-    while(--number) {
-        c = b;
-        b = a;
-        a = b + c;
+    // a = F(k) and b = F(k + 1) for the bits of number seen so far
+    T a(0);
+    T b(1);
+    for(size_t bit = detail::integer_bits(number); bit > 0;) {
+        --bit;
+        T twice(a * (b + b - a));
+        T next(a * a + b * b);
+        if((number >> bit) % 2 != 0) {
+            b = twice + next;
+            a = std::move(next);
+        }
+        else {
+            a = std::move(twice);
+            b = std::move(next);
+        }
     }
-
     return a;
 }
 
 /**
  * @ingroup math
  * @brief Calculates the Nth factorial.
- * @details Calculates the Nth factorial. The internal
- * implementation uses the naive recursion way of doing it
- * in order to preserve C++11 `constexpr` status.
+ * @details Calculates the Nth factorial. The product is split in
+ * halves recursively so both sides of every multiplication have about
+ * the same size, which lets `uintx` use its fast multiplication instead
+ * of multiplying a small number into a growing product N times. The
+ * recursion is only logarithmically deep and keeps its C++11 `constexpr`
+ * status for built-in types.
  *
  * @param number Which factorial to calculate.
  * @return Nth factorial number.
  */
 template<typename T>
 constexpr T factorial(const T& number) {
-    return number == 0 ? 1 : number * factorial(number - 1);
+    return number < 2 ? T(1) : detail::range_product(T(2), number);
 }
 
 /**
  * @ingroup math
  * @brief Calculates the greatest common divisor.
  * @details Calculates the greatest common divisor between
- * two numbers. Uses Euclid's algorithm to compute it.
+ * two numbers. Built-in integers use Stein's binary algorithm,
+ * which only needs shifts and subtractions, and the result is
+ * never negative. `uintx` and `intx` have overloads that use
+ * Lehmer's algorithm. Other types use an iterative version of
+ * Euclid's algorithm.
  *
  * @param x Left hand side.
  * @param y Right hand side.
  * @return The greatest common divisor between the numbers.
  */
 template<typename T>
-constexpr T gcd(const T& x, const T& y) {
-    return y == 0 ? x : gcd(y, x % y);
+inline T gcd(const T& x, const T& y) {
+    return detail::gcd(x, y, std::is_integral<T>{});
+}
+
+/**
+ * @ingroup math
+ * @brief Calculates the greatest common divisor and Bézout coefficients.
+ * @details Calculates `g = gcd(a, b)` along with `x` and `y` such that
+ * `a * x + b * y == g`, using the extended Euclidean algorithm. The
+ * coefficients can be negative, so `T` has to be a signed type such as
+ * `intx`. The gcd returned is never negative.
+ *
+ * @param a Left hand side.
+ * @param b Right hand side.
+ * @return A tuple of `g`, `x` and `y`, in that order.
+ */
+template<typename T>
+inline std::tuple<T, T, T> extended_gcd(const T& a, const T& b) {
+    T old_r(a), r(b);
+    T old_s(1), s(0);
+    T old_t(0), t(1);
+    while(r != 0) {
+        const T q = old_r / r;
+        T next(old_r - q * r);
+        old_r = std::move(r);
+        r = std::move(next);
+
+        next = old_s - q * s;
+        old_s = std::move(s);
+        s = std::move(next);
+
+        next = old_t - q * t;
+        old_t = std::move(t);
+        t = std::move(next);
+    }
+
+    if(old_r < 0) {
+        old_r = -old_r;
+        old_s = -old_s;
+        old_t = -old_t;
+    }
+    return std::make_tuple(std::move(old_r), std::move(old_s), std::move(old_t));
+}
+
+/**
+ * @ingroup math
+ * @brief Calculates the modular multiplicative inverse.
+ * @details Calculates `x` in `[0, modulus)` such that `(value * x) % modulus == 1`
+ * with the extended Euclidean algorithm. Only the coefficient of `value` is
+ * tracked and only its magnitude is stored, since its sign alternates at
+ * every step, so this works for unsigned types such as `uintx` as well.
+ * Both numbers must not be negative.
+ *
+ * @param value The number to invert.
+ * @param modulus The modulus.
+ * @return The inverse of `value` modulo `modulus`.
+ * @throws std::logic_error Thrown if the numbers are not coprime.
+ */
+template<typename T>
+inline T mod_inverse(const T& value, const T& modulus) {
+    T old_r(modulus), r(value % modulus);
+    T old_t(0), t(1);
+    bool negative = true;
+    while(r != 0) {
+        const T q = old_r / r;
+        T next(old_r - q * r);
+        old_r = std::move(r);
+        r = std::move(next);
+
+        next = old_t + q * t;
+        old_t = std::move(t);
+        t = std::move(next);
+        negative = !negative;
+    }
+
+    if(old_r != 1) {
+        throw std::logic_error("The modular inverse does not exist");
+    }
+
+    // value times old_t, negated if negative is set, is congruent to 1
+    return negative ? T(T(modulus - old_t) % modulus) : old_t;
 }
 
 /**
@@ -91,7 +623,8 @@ constexpr T gcd(const T& x, const T& y) {
  * @details Calculates the modular exponentiation. That is,
  * it computes essentially `(base ** exponent) % modulus` where
  * `**` denotes exponentiation. All numbers provided must be
- * positive.
+ * positive. This is a shorthand for `modular<T>(modulus).pow(base, exponent)`,
+ * construct a `modular` context directly to reuse it for the same modulus.
  *
  * @param base The base number of the formula.
  * @param exponent The exponent number of the formula.
@@ -100,80 +633,436 @@ constexpr T gcd(const T& x, const T& y) {
  */
 template<typename T>
 inline T mod_pow(T base, T exponent, const T& modulus) {
-    T result(1);
+    return modular<T>(modulus).pow(std::move(base), std::move(exponent));
+}
 
-    while(exponent) {
-        if((exponent % 2) == 1) {
-            result = (base * result) % modulus;
+/**
+ * @ingroup math
+ * @brief Checks if a number is prime.
+ * @details Checks if a number is prime. Built-in integers of up to 64 bits
+ * are trial divided by the primes below 100 and then go through Miller-Rabin
+ * with fixed witness sets that have no strong pseudoprimes in range, three
+ * bases for 32-bit numbers and seven for 64-bit ones, so the answer is exact
+ * and takes a few microseconds at most. Products are computed with
+ * `unsigned __int128` where available.
+ *
+ * Other types such as `uintx` use the Baillie-PSW test, a strong probable
+ * prime test to base 2 followed by a strong Lucas test. No composite number
+ * is known to pass it.
+ *
+ * @param number Number to test for primality.
+ * @return `true` is number is prime, `false` otherwise.
+ */
+template<typename T>
+inline bool is_prime(const T& number) {
+    return detail::is_prime(number, std::is_integral<T>());
+}
+
+namespace detail {
+// other types find their gcd through ADL
+inline unsigned long long gcd(unsigned long long x, unsigned long long y) noexcept {
+    return binary_gcd(x, y);
+}
+
+// odd primes below n, by a simple Sieve of Eratosthenes
+inline std::vector<unsigned> odd_primes_below(unsigned n) {
+    std::vector<unsigned> result;
+    std::vector<bool> composite(n / 2);
+    for(unsigned i = 1; i < n / 2; ++i) {
+        if(!composite[i]) {
+            const unsigned long long p = 2 * i + 1;
+            result.push_back(static_cast<unsigned>(p));
+            for(unsigned long long j = p * p / 2; j < n / 2; j += p) {
+                composite[j] = true;
+            }
         }
-        exponent /= 2;
-        base = (base * base) % modulus;
     }
+    return result;
+}
 
+inline const std::vector<unsigned>& trial_primes() {
+    static const std::vector<unsigned> table = odd_primes_below(GEARS_FACTOR_TRIAL_LIMIT);
+    return table;
+}
+
+template<typename T>
+inline T sub_mod(const T& lhs, const T& rhs, const T& modulus) {
+    return lhs < rhs ? T(lhs + (modulus - rhs)) : T(lhs - rhs);
+}
+
+// Brent's variant of Pollard's rho with x -> x^2 + c. The differences are
+// multiplied together so that only one gcd is taken every batch, and when
+// a batch overshoots to n the last one is redone a step at a time. Returns
+// n when no factor was found within about limit steps.
+template<typename T>
+inline T pollard_brent(const modular<T>& context, const T& c, size_t limit) {
+    const T& n = context.modulus();
+    const size_t batch = 128;
+    T y(2);
+    T x(y);
+    T saved(y);
+    T product(1);
+    T g(1);
+
+    for(size_t r = 1; g == T(1); r *= 2) {
+        if(r > limit) {
+            return n;
+        }
+
+        x = y;
+        for(size_t i = 0; i < r; ++i) {
+            y = add_mod(context.sqr(y), c, n);
+        }
+
+        for(size_t k = 0; k < r && g == T(1); k += batch) {
+            saved = y;
+            for(size_t i = 0; i < batch && i < r - k; ++i) {
+                y = add_mod(context.sqr(y), c, n);
+                product = context.mul(product, x < y ? T(y - x) : T(x - y));
+            }
+            g = gcd(product, n);
+        }
+    }
+
+    if(g == n) {
+        do {
+            saved = add_mod(context.sqr(saved), c, n);
+            g = gcd(x < saved ? T(saved - x) : T(x - saved), n);
+        }
+        while(g == T(1));
+    }
+    return g;
+}
+
+// Montgomery curve By^2 = x^3 + Ax^2 + x modulo n, with points in
+// projective x-only coordinates and a24 = (A + 2) / 4.
+template<typename T>
+struct montgomery_curve {
+    const modular<T>& context;
+    T a24;
+
+    montgomery_curve(const modular<T>& context, T a24): context(context), a24(std::move(a24)) {}
+
+    void twice(T& x, T& z) const {
+        const T& n = context.modulus();
+        const T sum(context.sqr(add_mod(x, z, n)));
+        const T difference(context.sqr(sub_mod(x, z, n)));
+        const T t(sub_mod(sum, difference, n));
+        x = context.mul(sum, difference);
+        z = context.mul(t, add_mod(difference, context.mul(a24, t), n));
+    }
+
+    // p + q, given p - q
+    void add(T& x, T& z, const T& xq, const T& zq, const T& xd, const T& zd) const {
+        const T& n = context.modulus();
+        const T u(context.mul(sub_mod(x, z, n), add_mod(xq, zq, n)));
+        const T v(context.mul(add_mod(x, z, n), sub_mod(xq, zq, n)));
+        x = context.mul(zd, context.sqr(add_mod(u, v, n)));
+        z = context.mul(xd, context.sqr(sub_mod(u, v, n)));
+    }
+
+    // kP with the Montgomery ladder, k > 0
+    void multiply(T& x, T& z, unsigned long long k) const {
+        const T xp(x);
+        const T zp(z);
+        T x2(x);
+        T z2(z);
+        twice(x2, z2);
+
+        size_t bit = 63;
+        while(!(k >> bit)) {
+            --bit;
+        }
+
+        while(bit > 0) {
+            --bit;
+            if((k >> bit) & 1) {
+                add(x, z, x2, z2, xp, zp);
+                twice(x2, z2);
+            }
+            else {
+                add(x2, z2, x, z, xp, zp);
+                twice(x, z);
+            }
+        }
+    }
+};
+
+// Stage one of Lenstra's elliptic curve method on the curve given by
+// Suyama's parametrisation for sigma. Returns n when no factor was found.
+template<typename T>
+inline T ecm_curve(const modular<T>& context, unsigned long long sigma, const std::vector<unsigned>& primes, unsigned bound) {
+    const T& n = context.modulus();
+    const T s(T(sigma) % n);
+    const T u(sub_mod(context.sqr(s), T(5) % n, n));
+    const T v(context.mul(T(4), s));
+    const T u3(context.mul(context.sqr(u), u));
+    T x(u3);
+    T z(context.mul(context.sqr(v), v));
+
+    // a24 = (v - u)^3 (3u + v) / (16 u^3 v)
+    const T w(sub_mod(v, u, n));
+    const T numerator(context.mul(context.mul(context.sqr(w), w), add_mod(context.mul(T(3), u), v, n)));
+    const T denominator(context.mul(context.mul(T(16), u3), v));
+    const T g(gcd(denominator, n));
+    if(g != T(1)) {
+        return g == T(0) ? n : g;
+    }
+
+    const montgomery_curve<T> curve(context, context.mul(numerator, mod_inverse(denominator, n)));
+    unsigned long long power = 1;
+    while(power * 2 <= bound) {
+        power *= 2;
+    }
+    curve.multiply(x, z, power);
+
+    for(unsigned p : primes) {
+        if(p > bound) {
+            break;
+        }
+
+        power = p;
+        while(power * p <= bound) {
+            power *= p;
+        }
+        curve.multiply(x, z, power);
+    }
+    return gcd(z, n);
+}
+
+// Tries curves with growing bounds, the classic choices for factors of 20,
+// 25, 30 and 35 digits, until one of them splits n.
+template<typename T>
+inline T elliptic_curve_method(const modular<T>& context) {
+    const T& n = context.modulus();
+    const unsigned bounds[] = { 11000, 50000, 250000, 1000000 };
+    const unsigned curves[] = { 90, 300, 700, 1800 };
+    unsigned long long sigma = 6;
+    for(size_t level = 0; true; level = level < 3 ? level + 1 : level) {
+        const std::vector<unsigned> primes = odd_primes_below(bounds[level] + 1);
+        for(unsigned i = 0; i < curves[level]; ++i) {
+            const T g(ecm_curve(context, sigma++, primes, bounds[level]));
+            if(g != n && g != T(1)) {
+                return g;
+            }
+        }
+    }
+}
+
+// a factor of n other than 1 and n, where n is odd and composite
+inline unsigned long long find_factor(unsigned long long n) {
+    const modular<unsigned long long> context(n);
+    for(unsigned long long c = 1; true; ++c) {
+        const unsigned long long g = pollard_brent(context, c, static_cast<size_t>(-1));
+        if(g != n) {
+            return g;
+        }
+    }
+}
+
+// Rho is quickest for factors of up to about 12 digits, larger ones are
+// left to the elliptic curve method.
+template<typename T>
+inline T find_factor(const T& n) {
+    const modular<T> context(n);
+    const T g(pollard_brent(context, T(1), 1 << 16));
+    return g != n ? g : elliptic_curve_method(context);
+}
+
+inline void factor_into(unsigned long long n, std::vector<unsigned long long>& out) {
+    const unsigned long long limit = GEARS_FACTOR_TRIAL_LIMIT;
+    if(n < limit * limit || is_prime(n)) {
+        out.push_back(n);
+        return;
+    }
+
+    const unsigned long long factor = find_factor(n);
+    factor_into(factor, out);
+    factor_into(n / factor, out);
+}
+
+// n has no factors below the trial division limit
+template<typename T>
+inline void factor_into(const T& n, std::vector<T>& out) {
+    if(integer_bits(n) <= 64) {
+        std::vector<unsigned long long> factors;
+        factor_into(low_bits(n), factors);
+        for(auto&& factor : factors) {
+            out.push_back(T(factor));
+        }
+        return;
+    }
+
+    if(is_prime(n, std::false_type())) {
+        out.push_back(n);
+        return;
+    }
+
+    const T factor(find_factor(n));
+    factor_into(factor, out);
+    factor_into(T(n / factor), out);
+}
+
+template<typename T>
+inline void remove_factor(T& n, unsigned p, std::vector<T>& out) {
+    while(n % T(p) == T(0)) {
+        n /= T(p);
+        out.push_back(T(p));
+    }
+}
+
+inline void trial_division(unsigned long long& n, std::vector<unsigned long long>& out) {
+    for(unsigned p : trial_primes()) {
+        if(static_cast<unsigned long long>(p) * p > n) {
+            break;
+        }
+        remove_factor(n, p, out);
+    }
+}
+
+// Large numbers are reduced once by a product of several primes that fits
+// in 32 bits and the primes are tested against that word sized remainder.
+template<typename T>
+inline void trial_division(T& n, std::vector<T>& out) {
+    const std::vector<unsigned>& primes = trial_primes();
+    for(size_t i = 0; i < primes.size() && integer_bits(n) > 64;) {
+        unsigned long long product = primes[i];
+        size_t end = i + 1;
+        for(; end < primes.size() && product * primes[end] <= 0xFFFFFFFFULL; ++end) {
+            product *= primes[end];
+        }
+
+        const unsigned long long rest = low_bits(T(n % T(product)));
+        for(; i < end; ++i) {
+            if(rest % primes[i] == 0) {
+                remove_factor(n, primes[i], out);
+            }
+        }
+    }
+
+    if(integer_bits(n) <= 64) {
+        unsigned long long small = low_bits(n);
+        std::vector<unsigned long long> factors;
+        trial_division(small, factors);
+        for(auto&& factor : factors) {
+            out.push_back(T(factor));
+        }
+        n = T(small);
+    }
+}
+
+inline std::vector<unsigned long long> prime_factors(unsigned long long n) {
+    std::vector<unsigned long long> result(count_trailing_zeros(n), 2ULL);
+    n >>= result.size();
+    trial_division(n, result);
+    if(n > 1) {
+        factor_into(n, result);
+    }
     return result;
 }
 
-/**
- * @ingroup math
- * @brief Calculates the sum of divisors function.
- * @details Calculates the sum of divisors of a given integer.
- * For example, the divisors for the number 12 are 1, 2, 3, 4,
- * 6, and 12. The sum of these numbers is 28. So
- * `sum_of_divisors(12)` would return 28.
- *
- * @param number The number to take the sum of divisors for.
- * @return The sum of the number's divisors.
- */
 template<typename T>
-inline T sum_of_divisors(const T& number) noexcept {
-    T result(0);
-    for(T i(1); i * i <= number; ++i) {
-        result += (number % i) ? 0 : ((i * i == number) ? i : i + number / i);
+inline std::vector<T> prime_factors(T n) {
+    std::vector<T> result(countr_zero(n), T(2));
+    n >>= result.size();
+    trial_division(n, result);
+    if(n > T(1)) {
+        factor_into(n, result);
     }
     return result;
 }
 
+template<typename T>
+inline std::vector<unsigned long long> prime_factors(const T& number, std::true_type) {
+    return prime_factors(static_cast<unsigned long long>(unsigned_abs(number)));
+}
+
+template<typename T>
+inline std::vector<T> prime_factors(const T& number, std::false_type) {
+    return prime_factors(T(number));
+}
+} // detail
+
 /**
  * @ingroup math
- * @brief Checks if a number is prime.
- * @details Checks if a number is prime using the
- * AKS primality test. This function is pretty slow for
- * numbers that are relatively large.
+ * @brief Factors an integer into primes.
+ * @details Factors an integer into primes, returned as pairs of a prime and
+ * its exponent in increasing order of the primes. The sign of the number
+ * is ignored, and 0 and 1 have no prime factors.
  *
- * @param number Number to test for primality.
- * @return `true` is number is prime, `false` otherwise.
+ * Factors of 2 are removed with a shift and the other primes below
+ * `GEARS_FACTOR_TRIAL_LIMIT` (4096 unless defined before including the file)
+ * by trial division against a sieved table. Whatever is left is split with
+ * Brent's variant of Pollard's rho, after `is_prime` has ruled out primes.
+ * That is enough for every 64-bit number. Larger types such as `uintx` only
+ * give rho a bounded number of steps and then use stage one of Lenstra's
+ * elliptic curve method with increasing bounds, which finds factors of up to
+ * 30 digits or so in reasonable time. Numbers that are a product of two
+ * larger primes will take a very long time to factor.
+ *
+ * Example:
+ * @code
+ * // 2^3 * 3^2 * 5
+ * for(auto&& factor : math::factorize(360)) {
+ *     std::cout << factor.first << '^' << factor.second << '\n';
+ * }
+ * @endcode
+ *
+ * @param number The number to factor.
+ * @return The prime factors and their exponents.
  */
 template<typename T>
-inline bool is_prime(const T& number) noexcept {
-    if(number == 1) {
-        return false;
+inline std::vector<std::pair<T, size_t>> factorize(const T& number) {
+    std::vector<std::pair<T, size_t>> result;
+    if(number == T(0)) {
+        return result;
     }
 
-    if(number < 4) {
-        return true;
-    }
-
-    if(number % 2 == 0) {
-        return false;
-    }
-
-    if(number < 9) {
-        return true;
+    auto primes = detail::prime_factors(number, std::is_integral<T>());
+    std::sort(primes.begin(), primes.end());
+    for(auto&& prime : primes) {
+        if(!result.empty() && result.back().first == T(prime)) {
+            ++result.back().second;
+        }
+        else {
+            result.emplace_back(T(prime), 1);
+        }
     }
+    return result;
+}
 
-    if(number % 3 == 0) {
-        return false;
+/**
+ * @ingroup math
+ * @brief Calculates the sum of divisors function.
+ * @details Calculates the sum of divisors of a given integer.
+ * For example, the divisors for the number 12 are 1, 2, 3, 4,
+ * 6, and 12. The sum of these numbers is 28. So
+ * `sum_of_divisors(12)` would return 28. The number is
+ * factored with `factorize` and the sum is the product of
+ * `1 + p + ... + p^e` over its prime powers `p^e`. Numbers that
+ * are not positive return 0. Built-in integers don't throw, while
+ * `uintx` can throw when allocating.
+ *
+ * @param number The number to take the sum of divisors for.
+ * @return The sum of the number's divisors.
+ */
+template<typename T>
+inline T sum_of_divisors(const T& number) noexcept(std::is_integral<T>::value) {
+    if(number <= T(0)) {
+        return T(0);
     }
 
-    const T r(std::sqrt(number));
-    T f(5);
-    while(f <= r) {
-        if(number % f == 0 || number % (f + 2) == 0) {
-            return false;
+    T result(1);
+    for(auto&& factor : factorize(number)) {
+        T sum(1);
+        T power(1);
+        for(size_t i = 0; i < factor.second; ++i) {
+            power *= factor.first;
+            sum += power;
         }
-        f += 6;
+        result *= sum;
     }
-    return true;
+    return result;
 }
 
 /**
@@ -23,22 +23,352 @@
 #define GEARS_MATH_GENERATOR_HPP
 
 #include <vector>
+#include <tuple>
 #include <iterator>
-#include <cmath>
+#include <algorithm>
 #include <gears/math/algorithm.hpp>
+#include <gears/detail/parallel.hpp>
+
+// Number of bytes, one per odd number, that the prime sieves process at a
+// time. The default fits in the L1 cache of most processors.
+#ifndef GEARS_PRIME_SIEVE_SEGMENT
+#define GEARS_PRIME_SIEVE_SEGMENT 32768
+#endif // GEARS_PRIME_SIEVE_SEGMENT
+
+// Smallest amount of numbers that a thread of the parallel prime sieves
+// takes at a time. Smaller chunks balance better but every chunk has to
+// sieve its own primes up to the square root of its end.
+#ifndef GEARS_PRIME_SIEVE_CHUNK
+#define GEARS_PRIME_SIEVE_CHUNK 16777216
+#endif // GEARS_PRIME_SIEVE_CHUNK
 
 namespace gears {
 namespace math {
+namespace detail {
+// Segmented Sieve of Eratosthenes over the odd numbers, odd number n being
+// at index n / 2. Blocks of GEARS_PRIME_SIEVE_SEGMENT bytes are sieved on
+// demand and the sieving primes are extended whenever a block reaches past
+// the square of the largest one, so it can start anywhere and run for as
+// long as needed while memory stays O(sqrt(n)) for the largest n reached.
+// Primes at least as large as a block strike it at most once, so instead of
+// being looked at for every block they wait in a bucket for the block that
+// holds their next multiple.
+class prime_sieve {
+private:
+    std::vector<unsigned long long> sieving;
+    std::vector<unsigned long long> next;
+    std::vector<std::vector<size_t>> buckets;
+    std::vector<size_t> due;
+    std::vector<unsigned char> flags;
+    unsigned long long bound;
+    unsigned long long low;
+    unsigned long long stop;
+    unsigned long long current;
+    size_t size;
+    size_t position;
+    size_t small;
+    bool two;
+
+    // queues sieving prime k for the block holding its next multiple, blocks
+    // past the end of the buckets wrap around and are queued again when seen
+    void schedule(size_t k) {
+        const unsigned long long block = current + (next[k] - low) / GEARS_PRIME_SIEVE_SEGMENT;
+        buckets[static_cast<size_t>(block % buckets.size())].push_back(k);
+    }
+
+    // adds the odd primes up to at least root, sieving the numbers past the
+    // current bound a block at a time with the primes already known
+    void extend(unsigned long long root) {
+        // the square of a larger prime would not fit
+        const unsigned long long most = 0xFFFFFFFFULL;
+        const unsigned long long limit = root > 2 * bound ? root : 2 * bound < most ? 2 * bound : most;
+        const size_t known = sieving.size();
+        std::vector<unsigned char> block;
+        while(bound < limit) {
+            // composites up to (bound + 1)^2 have a prime factor up to bound
+            const unsigned long long top = bound < 65536 && bound * (bound + 2) < limit ? bound * (bound + 2) : limit;
+            const size_t primes = sieving.size();
+            for(unsigned long long first = (bound + 1) / 2, last = (top - 1) / 2 + 1; first < last; first += GEARS_PRIME_SIEVE_SEGMENT) {
+                const unsigned long long end = last - first < GEARS_PRIME_SIEVE_SEGMENT ? last : first + GEARS_PRIME_SIEVE_SEGMENT;
+                block.assign(static_cast<size_t>(end - first), 1);
+                for(size_t k = 0; k < primes && sieving[k] * sieving[k] < 2 * end; ++k) {
+                    const unsigned long long p = sieving[k];
+                    const unsigned long long start = p * p / 2 > first ? p * p / 2 : first;
+                    for(unsigned long long j = start + (p / 2 + p - start % p) % p; j < end; j += p) {
+                        block[static_cast<size_t>(j - first)] = 0;
+                    }
+                }
+
+                for(unsigned long long i = first; i < end; ++i) {
+                    if(block[static_cast<size_t>(i - first)]) {
+                        // the indices of the odd multiples of p are i modulo p
+                        const unsigned long long p = 2 * i + 1;
+                        const unsigned long long start = p * p / 2 > low ? p * p / 2 : low;
+                        sieving.push_back(p);
+                        next.push_back(start + (i + p - start % p) % p);
+                    }
+                }
+            }
+            bound = top;
+        }
+
+        while(small < sieving.size() && sieving[small] < GEARS_PRIME_SIEVE_SEGMENT) {
+            ++small;
+        }
+
+        // a prime never jumps more than bound / segment + 1 blocks ahead
+        const size_t needed = static_cast<size_t>(bound / GEARS_PRIME_SIEVE_SEGMENT) + 2;
+        size_t k = known > small ? known : small;
+        if(buckets.size() < needed) {
+            buckets.assign(needed, std::vector<size_t>());
+            k = small;
+        }
+
+        for(; k < sieving.size(); ++k) {
+            schedule(k);
+        }
+    }
+
+    bool advance() {
+        low += size;
+        current += size != 0;
+        position = 0;
+        if(low >= stop) {
+            size = 0;
+            return false;
+        }
+
+        size = static_cast<size_t>(stop - low < GEARS_PRIME_SIEVE_SEGMENT ? stop - low : GEARS_PRIME_SIEVE_SEGMENT);
+        const unsigned long long root = iroot(2 * (low + size) - 1, 2);
+        if(root > bound) {
+            extend(root);
+        }
+
+        flags.assign(size, 1);
+        unsigned char* data = flags.data();
+        for(size_t k = 0; k < small; ++k) {
+            if(next[k] >= low + size) {
+                continue;
+            }
+
+            const size_t p = static_cast<size_t>(sieving[k]);
+            size_t j = static_cast<size_t>(next[k] - low);
+            for(; j < size; j += p) {
+                data[j] = 0;
+            }
+            next[k] = low + j;
+        }
+
+        if(!buckets.empty()) {
+            due.swap(buckets[static_cast<size_t>(current % buckets.size())]);
+            for(size_t k : due) {
+                if(next[k] < low + size) {
+                    data[next[k] - low] = 0;
+                    next[k] += sieving[k];
+                }
+                schedule(k);
+            }
+            due.clear();
+        }
+        return true;
+    }
+public:
+    // generates the primes in [first, last)
+    prime_sieve(unsigned long long first, unsigned long long last):
+        bound(1), low(first / 2 > 1 ? first / 2 : 1), stop(last / 2), current(0), size(0), position(0), small(0), two(first <= 2 && last > 2) {}
+
+    // returns the next prime or 0 when there are no more
+    unsigned long long operator()() {
+        if(two) {
+            two = false;
+            return 2;
+        }
+
+        while(true) {
+            while(position < size) {
+                if(flags[position++]) {
+                    return 2 * (low + position) - 1;
+                }
+            }
+
+            if(!advance()) {
+                return 0;
+            }
+        }
+    }
+
+    // bytes held for the current block
+    size_t block_size() const noexcept {
+        return flags.capacity();
+    }
+
+    // consumes the rest of the primes and returns how many there were
+    unsigned long long count() {
+        unsigned long long result = two ? 1 : 0;
+        two = false;
+        do {
+            const unsigned char* data = flags.data();
+            size_t block = 0;
+            for(size_t i = position; i < size; ++i) {
+                block += data[i];
+            }
+            result += block;
+            position = size;
+        }
+        while(advance());
+        return result;
+    }
+};
+
+// Euler's linear sieve. Every composite n is crossed off exactly once, as
+// p * m for its smallest prime factor p, and m is always reached before n,
+// so the smallest prime factor of every number up to limit is found in
+// O(limit) time. The smallest factor of a composite below 2^32 is below
+// 2^16, so the table keeps 16 bits per number, 0 standing for the number
+// itself.
+inline std::vector<unsigned short> linear_sieve(unsigned limit) {
+    std::vector<unsigned short> factors(static_cast<size_t>(limit) + 1, 0);
+    std::vector<unsigned> found;
+    for(size_t i = 2; i <= limit; ++i) {
+        unsigned smallest = factors[i];
+        if(smallest == 0) {
+            smallest = static_cast<unsigned>(i);
+            found.push_back(smallest);
+        }
+
+        for(unsigned p : found) {
+            const unsigned long long n = static_cast<unsigned long long>(i) * p;
+            if(p > smallest || n > limit) {
+                break;
+            }
+            factors[static_cast<size_t>(n)] = static_cast<unsigned short>(p);
+        }
+    }
+    return factors;
+}
+
+// Sieves a multiplicative function one block of GEARS_PRIME_SIEVE_SEGMENT
+// numbers at a time. Every number in the block is divided by the primes up
+// to the square root of the block's end, and its value is the product of
+// power(p, k, p^k) over the prime powers p^k divided out, what is left over
+// being a prime of its own. emit(value) is called for every number from 0
+// to limit in order, 0 getting Value(0), so the only memory used besides
+// the output is one block and the primes up to the square root of limit.
+template<typename Value, typename Power, typename Emit>
+inline void multiplicative_sieve(unsigned limit, Power power, Emit emit) {
+    const auto factors = linear_sieve(static_cast<unsigned>(isqrt(limit)));
+    std::vector<unsigned> primes;
+    for(size_t n = 2; n < factors.size(); ++n) {
+        if(factors[n] == 0) {
+            primes.push_back(static_cast<unsigned>(n));
+        }
+    }
+
+    std::vector<Value> values;
+    std::vector<unsigned> rest;
+    emit(Value(0));
+    for(unsigned long long low = 1; low <= limit; low += GEARS_PRIME_SIEVE_SEGMENT) {
+        const unsigned long long high = std::min(low + GEARS_PRIME_SIEVE_SEGMENT, limit + 1ULL);
+        const size_t size = static_cast<size_t>(high - low);
+        values.assign(size, Value(1));
+        rest.resize(size);
+        for(size_t i = 0; i < size; ++i) {
+            rest[i] = static_cast<unsigned>(low + i);
+        }
+
+        for(unsigned p : primes) {
+            if(static_cast<unsigned long long>(p) * p >= high) {
+                break;
+            }
+
+            for(unsigned long long n = (low + p - 1) / p * p; n < high; n += p) {
+                const size_t i = static_cast<size_t>(n - low);
+                unsigned long long pk = p;
+                unsigned k = 1;
+                for(rest[i] /= p; rest[i] % p == 0; rest[i] /= p) {
+                    pk *= p;
+                    ++k;
+                }
+                values[i] = values[i] * power(p, k, pk);
+            }
+        }
+
+        for(size_t i = 0; i < size; ++i) {
+            if(rest[i] != 1) {
+                values[i] = values[i] * power(rest[i], 1, rest[i]);
+            }
+            emit(values[i]);
+        }
+    }
+}
+
+// Depth-first walk of the Berggren tree of primitive Pythagorean triples.
+// Every primitive triple (a, b, c) with odd a is reached exactly once from
+// (3, 4, 5) through the three children below, and each child has a larger
+// perimeter than its parent, so a subtree is pruned as soon as its root is
+// over the limit. The stack holds at most two siblings per level, which keeps
+// memory O(depth). With multiples set every primitive triple is followed by
+// its multiples that fit before the walk moves on.
+class triple_walker {
+public:
+    using triple = std::tuple<unsigned long long, unsigned long long, unsigned long long>;
+private:
+    std::vector<triple> stack;
+    triple primitive;
+    unsigned long long limit;
+    unsigned long long scale;
+    bool multiples;
+
+    void push(unsigned long long a, unsigned long long b, unsigned long long c) {
+        if(a + b + c <= limit) {
+            stack.emplace_back(a, b, c);
+        }
+    }
+public:
+    triple_walker(unsigned long long limit, bool multiples): primitive(0, 0, 0), limit(limit), scale(0), multiples(multiples) {
+        push(3, 4, 5);
+    }
+
+    // returns (0, 0, 0) once every triple has been generated
+    triple operator()() {
+        unsigned long long a, b, c;
+        std::tie(a, b, c) = primitive;
+        if(multiples && scale != 0 && a + b + c <= limit / (scale + 1)) {
+            ++scale;
+            return triple(a * scale, b * scale, c * scale);
+        }
+
+        if(stack.empty()) {
+            scale = 0;
+            return triple(0, 0, 0);
+        }
+
+        primitive = stack.back();
+        stack.pop_back();
+        scale = 1;
+        std::tie(a, b, c) = primitive;
+        push(2 * b + 2 * c - a, b + 2 * c - 2 * a, 2 * b + 3 * c - 2 * a);
+        push(a + 2 * b + 2 * c, 2 * a + b + 2 * c, 2 * a + 2 * b + 3 * c);
+        push(a + 2 * c - 2 * b, 2 * a + 2 * c - b, 2 * a + 3 * c - 2 * b);
+        return primitive;
+    }
+};
+
+} // detail
+
 /**
  * @ingroup math
- * @brief Generates primes using a modified Sieve of Eratosthenes.
- * @details Generates primes using a modified Sieve of Eratosthenes. The
- * function will generate primes up to the limit provided. e.g. if limit is
- * 100, then the last prime generated would be 97. The container must have an
- * integral `value_type` for best results. Currently this function only works
- * on containers that provide the `push_back` function. This might be changed
- * in the future. The first two primes (2 and 3) are always provided regardless
- * of the limit given.
+ * @brief Generates primes using a segmented Sieve of Eratosthenes.
+ * @details Generates primes using a segmented Sieve of Eratosthenes. The
+ * function will generate the primes below the limit provided. e.g. if limit is
+ * 100, then the last prime generated would be 97. Only odd numbers are sieved,
+ * in blocks of at least `GEARS_PRIME_SIEVE_SEGMENT` bytes (32768 unless defined
+ * before including the file) so the working set stays in cache, and the memory
+ * used besides the container is proportional to the square root of the limit.
+ * The container must have an integral `value_type` for best results. Currently
+ * this function only works on containers that provide the `push_back` function.
+ * This might be changed in the future. The first two primes (2 and 3) are always
+ * provided regardless of the limit given.
  *
  * @param limit The upper limit of primes to generate.
  * @param cont The container to insert the primes to.
@@ -47,31 +377,276 @@ template<typename Container, typename Value = typename Container::value_type>
 inline void primes(Value limit, Container& cont) {
     cont.push_back(2);
     cont.push_back(3);
+    if(limit > 5) {
+        detail::prime_sieve sieve(5, static_cast<unsigned long long>(limit));
+        for(unsigned long long prime = sieve(); prime != 0; prime = sieve()) {
+            cont.push_back(static_cast<Value>(prime));
+        }
+    }
+}
 
-    Value offset = limit % 6 > 1;
-    Value wheels[6] = { limit, limit - 1, limit + 4, limit + 3, limit + 2, limit + 1 };
-    Value k = 0;
-    Value n = wheels[limit % 6];
-    std::vector<bool> sieve(n / 3, true);
-    sieve[0] = false;
-    for(Value i = 0, upper = static_cast<Value>(std::sqrt(n))/3; i <= upper; ++i) {
-        if(sieve[i]) {
-            k = (3 * i + 1) | 1;
-            for(Value j = (k * k) / 3; j < n / 3; j += 2 * k) {
-                sieve[j] = false;
-            }
+/**
+ * @ingroup math
+ * @brief Generates primes on multiple threads.
+ * @details Generates the same primes as the two parameter overload, the primes
+ * below the limit, but splits the range into chunks of at least
+ * `GEARS_PRIME_SIEVE_CHUNK` numbers that are sieved on a pool of threads. The
+ * primes of every chunk are inserted into the container in increasing order
+ * once all of the chunks are done, so the memory used is about twice the size
+ * of the result.
+ *
+ * @param limit The upper limit of primes to generate.
+ * @param cont The container to insert the primes to.
+ * @param threads The number of threads to use, 0 means one per hardware thread.
+ */
+template<typename Container, typename Value = typename Container::value_type>
+inline void primes(Value limit, Container& cont, unsigned threads) {
+    cont.push_back(2);
+    cont.push_back(3);
+    if(limit <= 5) {
+        return;
+    }
 
-            for(Value j = (k * k + 4 * k - 2 * k * (i & 1)) / 3; j < n / 3; j += 2 * k) {
-                sieve[j] = false;
-            }
+    const unsigned long long last = static_cast<unsigned long long>(limit);
+    threads = gears::detail::thread_count(threads);
+    std::vector<std::vector<Value>> chunks(gears::detail::chunk_count(last - 5, GEARS_PRIME_SIEVE_CHUNK, threads));
+    gears::detail::parallel_chunks(5, last, chunks.size(), threads, [&](unsigned long long begin, unsigned long long end, size_t index) {
+        detail::prime_sieve sieve(begin, end);
+        for(unsigned long long prime = sieve(); prime != 0; prime = sieve()) {
+            chunks[index].push_back(static_cast<Value>(prime));
         }
-    }
+    });
 
-    for(Value i = 1; i < n / 3 - offset; ++i) {
-        if(sieve[i]) {
-            cont.push_back((3 * i + 1) | 1);
+    for(auto&& chunk : chunks) {
+        for(auto&& prime : chunk) {
+            cont.push_back(prime);
         }
+        std::vector<Value>().swap(chunk);
+    }
+}
+
+/**
+ * @ingroup math
+ * @brief Counts the primes up to a number.
+ * @details Computes the prime counting function, the number of primes less
+ * than or equal to `number`, with a segmented sieve that only counts the
+ * primes of every block instead of storing them. The range is split into
+ * chunks of at least `GEARS_PRIME_SIEVE_CHUNK` numbers that are sieved on a
+ * pool of threads, each of them only needing a cache sized block and the
+ * primes up to the square root of its end.
+ *
+ * Example:
+ * @code
+ * std::cout << math::prime_count(1000000000); // 50847534
+ * @endcode
+ *
+ * @param number The number to count primes up to.
+ * @param threads The number of threads to use, 0 means one per hardware thread.
+ * @return The number of primes less than or equal to `number`.
+ */
+inline unsigned long long prime_count(unsigned long long number, unsigned threads = 0) {
+    const unsigned long long last = number == static_cast<unsigned long long>(-1) ? number : number + 1;
+    threads = gears::detail::thread_count(threads);
+    std::vector<unsigned long long> counts(gears::detail::chunk_count(last, GEARS_PRIME_SIEVE_CHUNK, threads));
+    gears::detail::parallel_chunks(0, last, counts.size(), threads, [&](unsigned long long begin, unsigned long long end, size_t index) {
+        counts[index] = detail::prime_sieve(begin, end).count();
+    });
+
+    unsigned long long result = 0;
+    for(auto&& count : counts) {
+        result += count;
     }
+    return result;
+}
+
+/**
+ * @ingroup math
+ * @brief Iterator that lazily generates primes.
+ * @details An input iterator over the primes generated by a `prime_range`.
+ * Incrementing it sieves the next block once the current one runs out.
+ * This should not be used directly.
+ */
+struct prime_iterator : std::iterator<std::input_iterator_tag, unsigned long long> {
+private:
+    detail::prime_sieve* sieve;
+    unsigned long long value;
+public:
+    prime_iterator() noexcept: sieve(nullptr), value(0) {}
+    prime_iterator(detail::prime_sieve& sieve): sieve(&sieve), value(sieve()) {}
+
+    prime_iterator& operator++() {
+        value = (*sieve)();
+        return *this;
+    }
+
+    prime_iterator operator++(int) {
+        auto copy = *this;
+        ++(*this);
+        return copy;
+    }
+
+    const unsigned long long& operator*() const noexcept {
+        return value;
+    }
+
+    const unsigned long long* operator->() const noexcept {
+        return &value;
+    }
+
+    bool operator==(const prime_iterator& other) const noexcept {
+        return value == other.value;
+    }
+
+    bool operator!=(const prime_iterator& other) const noexcept {
+        return not (*this == other);
+    }
+};
+
+/**
+ * @ingroup math
+ * @brief A range object that returns prime_iterators.
+ * @details A range object that returns prime_iterators. It owns the sieve
+ * and can only be iterated once. This shouldn't be used directly and
+ * instead should be used with `primes_from`.
+ */
+struct prime_range {
+private:
+    detail::prime_sieve sieve;
+public:
+    prime_range(unsigned long long first, unsigned long long last): sieve(first, last) {}
+
+    prime_iterator begin() {
+        return { sieve };
+    }
+
+    prime_iterator end() noexcept {
+        return { };
+    }
+};
+
+/**
+ * @ingroup math
+ * @brief Returns a range that lazily generates primes.
+ * @details Returns a range over the primes in `[first, last)`, in increasing
+ * order. The primes are sieved one block at a time as the range is iterated,
+ * so nothing past the last prime read is computed. Memory is a single block
+ * plus the sieving primes up to the square root of the largest prime read.
+ * Best used with the range-based for loop.
+ *
+ * Example:
+ * @code
+ * // the first 10 primes past a trillion
+ * int count = 0;
+ * for(auto&& prime : math::primes_from(1000000000000ULL)) {
+ *     std::cout << prime << '\n';
+ *     if(++count == 10) {
+ *         break;
+ *     }
+ * }
+ * @endcode
+ *
+ * @param first The smallest number to consider.
+ * @param last One past the largest number to consider. Unbounded by default.
+ * @return `prime_range` object to iterate through.
+ */
+inline prime_range primes_from(unsigned long long first, unsigned long long last = static_cast<unsigned long long>(-1)) {
+    return prime_range(first, last);
+}
+
+/**
+ * @ingroup math
+ * @brief Generates the smallest prime factor of every number up to a limit.
+ * @details Generates the smallest prime factor of every number from 0 to
+ * `limit` inclusive, so that the value for `n` is the `n`th element inserted.
+ * The values for 0 and 1 are 0 and 1. Uses Euler's linear sieve, which
+ * crosses off every composite exactly once and runs in O(limit) time. The
+ * table makes factoring any of the numbers a matter of repeated division.
+ * The limit must fit in an `unsigned int`.
+ *
+ * @param limit The largest number to generate the value for.
+ * @param cont The container to insert the values to.
+ */
+template<typename Container, typename Value = typename Container::value_type>
+inline void smallest_prime_factors(Value limit, Container& cont) {
+    const auto factors = detail::linear_sieve(static_cast<unsigned>(limit));
+    for(size_t n = 0; n < factors.size(); ++n) {
+        cont.push_back(static_cast<Value>(factors[n] == 0 ? n : factors[n]));
+    }
+}
+
+/**
+ * @ingroup math
+ * @brief Generates Euler's totient of every number up to a limit.
+ * @details Generates Euler's totient function, the count of numbers up to
+ * `n` that are coprime to `n`, for every `n` from 0 to `limit` inclusive. The
+ * value for `n` is the `n`th element inserted and the value for 0 is 0. The
+ * numbers are sieved in blocks of `GEARS_PRIME_SIEVE_SEGMENT` and every
+ * prime power `p^k` found contributes `p^(k - 1) * (p - 1)`, so memory
+ * besides the container is one block. The limit must fit in an
+ * `unsigned int`.
+ *
+ * @param limit The largest number to generate the value for.
+ * @param cont The container to insert the values to.
+ */
+template<typename Container, typename Value = typename Container::value_type>
+inline void totients(Value limit, Container& cont) {
+    using result = typename Container::value_type;
+    detail::multiplicative_sieve<result>(static_cast<unsigned>(limit), [](unsigned long long p, unsigned, unsigned long long pk) {
+        return result(pk / p * (p - 1));
+    },
+    [&](const result& value) {
+        cont.push_back(value);
+    });
+}
+
+/**
+ * @ingroup math
+ * @brief Generates the Mobius function of every number up to a limit.
+ * @details Generates the Mobius function for every `n` from 0 to `limit`
+ * inclusive, which is 0 when `n` has a squared prime factor and otherwise 1
+ * or -1 for an even or odd number of prime factors. The value for `n` is the
+ * `n`th element inserted and the value for 0 is 0. The numbers are sieved
+ * in blocks of `GEARS_PRIME_SIEVE_SEGMENT`, so memory besides the container
+ * is one block. The value type of the container has to be signed. The
+ * limit must fit in an `unsigned int`.
+ *
+ * @param limit The largest number to generate the value for.
+ * @param cont The container to insert the values to.
+ */
+template<typename Container, typename Value = typename Container::value_type>
+inline void moebius(Value limit, Container& cont) {
+    using result = typename Container::value_type;
+    detail::multiplicative_sieve<result>(static_cast<unsigned>(limit), [](unsigned long long, unsigned k, unsigned long long) {
+        return result(k > 1 ? 0 : -1);
+    },
+    [&](const result& value) {
+        cont.push_back(value);
+    });
+}
+
+/**
+ * @ingroup math
+ * @brief Generates the sum of divisors of every number up to a limit.
+ * @details Generates the sum of divisors function for every `n` from 0 to
+ * `limit` inclusive, the same values as calling `sum_of_divisors` on each
+ * of them. The value for `n` is the `n`th element inserted and the value
+ * for 0 is 0. The numbers are sieved in blocks of
+ * `GEARS_PRIME_SIEVE_SEGMENT` and every prime power `p^k` found contributes
+ * `1 + p + ... + p^k`, so memory besides the container is one block. The
+ * limit must fit in an `unsigned int`.
+ *
+ * @param limit The largest number to generate the value for.
+ * @param cont The container to insert the values to.
+ */
+template<typename Container, typename Value = typename Container::value_type>
+inline void divisor_sums(Value limit, Container& cont) {
+    using result = typename Container::value_type;
+    detail::multiplicative_sieve<result>(static_cast<unsigned>(limit), [](unsigned long long p, unsigned, unsigned long long pk) {
+        return result((pk * p - 1) / (p - 1));
+    },
+    [&](const result& value) {
+        cont.push_back(value);
+    });
 }
 
 /**
@@ -108,6 +683,100 @@ inline void pythagorean_triples(Integral limit, Container& cont) {
         }
     }
 }
+
+/**
+ * @ingroup math
+ * @brief Iterator that lazily generates Pythagorean triples.
+ * @details An input iterator over the triples generated by a
+ * `pythagorean_range`. The value is a tuple of the two legs, odd one first,
+ * followed by the hypotenuse. This should not be used directly.
+ */
+struct pythagorean_iterator : std::iterator<std::input_iterator_tag, std::tuple<unsigned long long, unsigned long long, unsigned long long>> {
+private:
+    detail::triple_walker* walker;
+    value_type triple;
+public:
+    pythagorean_iterator() noexcept: walker(nullptr), triple(0, 0, 0) {}
+    pythagorean_iterator(detail::triple_walker& walker): walker(&walker), triple(walker()) {}
+
+    pythagorean_iterator& operator++() {
+        triple = (*walker)();
+        return *this;
+    }
+
+    pythagorean_iterator operator++(int) {
+        auto copy = *this;
+        ++(*this);
+        return copy;
+    }
+
+    const value_type& operator*() const noexcept {
+        return triple;
+    }
+
+    const value_type* operator->() const noexcept {
+        return &triple;
+    }
+
+    bool operator==(const pythagorean_iterator& other) const noexcept {
+        return triple == other.triple;
+    }
+
+    bool operator!=(const pythagorean_iterator& other) const noexcept {
+        return not (*this == other);
+    }
+};
+
+/**
+ * @ingroup math
+ * @brief A range object that returns pythagorean_iterators.
+ * @details A range object that returns pythagorean_iterators. It owns the
+ * tree walk and can only be iterated once. This shouldn't be used directly
+ * and instead should be used with `pythagorean_tree`.
+ */
+struct pythagorean_range {
+private:
+    detail::triple_walker walker;
+public:
+    pythagorean_range(unsigned long long perimeter, bool multiples): walker(perimeter, multiples) {}
+
+    pythagorean_iterator begin() {
+        return { walker };
+    }
+
+    pythagorean_iterator end() noexcept {
+        return { };
+    }
+};
+
+/**
+ * @ingroup math
+ * @brief Returns a range that lazily generates Pythagorean triples.
+ * @details Returns a range over the Pythagorean triples whose perimeter is at
+ * most `perimeter`, without storing them. The primitive triples are found by
+ * walking the Berggren tree depth first, so there are no gcd tests and the
+ * memory used is proportional to the depth of the tree, which is about
+ * `sqrt(perimeter / 8)`. If `multiples` is true, every primitive triple is
+ * followed by its multiples within the perimeter, so that every triple is
+ * generated once. The triples are not generated in any particular order. The
+ * perimeter must be below 2^61 so the children of a triple cannot overflow.
+ *
+ * Example:
+ * @code
+ * // count the right triangles with a perimeter of at most a billion
+ * unsigned long long count = 0;
+ * for(auto&& triple : math::pythagorean_tree(1000000000, true)) {
+ *     ++count;
+ * }
+ * @endcode
+ *
+ * @param perimeter The largest perimeter of the triples to generate.
+ * @param multiples Whether to generate the non-primitive triples as well.
+ * @return `pythagorean_range` object to iterate through.
+ */
+inline pythagorean_range pythagorean_tree(unsigned long long perimeter, bool multiples = false) {
+    return pythagorean_range(perimeter, multiples);
+}
 } // math
 } // gears
 
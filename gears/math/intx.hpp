@@ -0,0 +1,498 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef GEARS_MATH_INTX_HPP
+#define GEARS_MATH_INTX_HPP
+
+#include <gears/math/uintx.hpp>
+
+namespace gears {
+namespace math {
+namespace detail {
+template<typename T>
+constexpr typename std::enable_if<std::is_signed<T>::value, bool>::type is_negative(T value) noexcept {
+    return value < 0;
+}
+
+template<typename T>
+constexpr typename std::enable_if<!std::is_signed<T>::value, bool>::type is_negative(T) noexcept {
+    return false;
+}
+
+template<typename T, bool = std::is_integral<T>::value>
+struct signed_cast {
+    template<typename Magnitude>
+    T operator()(const Magnitude& magnitude, bool negative) const {
+        using unsigned_type = gears::meta::eval<std::make_unsigned<T>>;
+        const auto value = uintx_cast<unsigned_type>(magnitude);
+        return static_cast<T>(negative ? static_cast<unsigned_type>(unsigned_type(0) - value) : value);
+    }
+};
+
+template<typename T>
+struct signed_cast<T, false> {
+    template<typename Magnitude>
+    T operator()(const Magnitude& magnitude, bool negative) const {
+        const auto value = uintx_cast<T>(magnitude);
+        return negative ? -value : value;
+    }
+};
+
+template<>
+struct signed_cast<std::string, false> {
+    template<typename Magnitude>
+    std::string operator()(const Magnitude& magnitude, bool negative) const {
+        auto str = uintx_cast<std::string>(magnitude);
+        return negative ? '-' + str : str;
+    }
+};
+} // detail
+
+/**
+ * @ingroup math
+ * @brief Multi-precision signed integer.
+ * @details Multi-precision signed integer. The value is kept in sign and
+ * magnitude form, with the magnitude being a `uintx` of the same template
+ * parameters. Every operation works on the magnitude in place through the
+ * same limb kernels `uintx` uses, so the sign costs neither an extra copy
+ * nor an extra allocation. Zero is never negative.
+ *
+ * Division truncates towards zero and the remainder takes the sign of the
+ * dividend, like the built-in integer types.
+ *
+ * When the precision is bounded, the magnitude is bounded by `Bits` and
+ * wraps around modulo 2<sup>Bits</sup> like `uintx` does, so the
+ * representable range is symmetric around zero. Bitwise operators are not
+ * provided, use the magnitude directly if they are needed.
+ *
+ * @tparam Bits Bits of precision of the magnitude. Defaults to -1 for "infinite" precision.
+ * @tparam Digit Underlying type of a single limb.
+ * @tparam Digits Underlying type used to hold the result of two limbs.
+ */
+template<size_t Bits = static_cast<size_t>(-1), typename Digit = unsigned int, typename Digits = unsigned long long>
+struct intx {
+public:
+    /**
+     * @brief The type of the magnitude.
+     */
+    using magnitude_type = uintx<Bits, Digit, Digits>;
+private:
+    magnitude_type value;
+    bool negative;
+
+    void normalize() noexcept {
+        negative = negative && static_cast<bool>(value);
+    }
+
+    // *this += (subtract ? -1 : 1) * other
+    void accumulate(const intx& other, bool subtract) {
+        const bool other_negative = other.negative != subtract;
+        if(negative == other_negative) {
+            value += other.value;
+            return;
+        }
+
+        const auto& lhs = value.digits;
+        const auto& rhs = other.value.digits;
+        if(detail::compare(lhs.data(), lhs.size(), rhs.data(), rhs.size()) >= 0) {
+            value -= other.value;
+        }
+        else {
+            value.subtract_from(other.value);
+            negative = other_negative;
+        }
+        normalize();
+    }
+public:
+    /**
+     * @brief Default constructor.
+     * @details Sets intx to 0.
+     */
+    constexpr intx() noexcept: value(), negative(false) {}
+
+    /**
+     * @brief Constructs from an integer.
+     * @details Constructs intx from an integer type, keeping its sign.
+     * Bit-checking is done on the magnitude. When the precision is
+     * bounded this constructor is `constexpr`.
+     *
+     * @param integer Value to set intx to.
+     */
+    template<typename Integer, gears::meta::enable_if_t<std::is_integral<Integer>> = gears::meta::_>
+    constexpr intx(Integer integer): value(integer), negative(detail::is_negative(integer)) {}
+
+    /**
+     * @brief Constructs from a magnitude and a sign.
+     * @details Constructs intx from a uintx magnitude, which is moved
+     * into place without copying its limbs.
+     *
+     * @param magnitude The absolute value.
+     * @param negative Whether the value is negative. Ignored if the magnitude is 0.
+     */
+    intx(magnitude_type magnitude, bool negative = false): value(std::move(magnitude)), negative(negative) {
+        normalize();
+    }
+
+    /**
+     * @brief Constructs from a string.
+     * @details Constructs intx from a string written in the given base,
+     * optionally preceded by a `+` or `-` sign. The rest of the string
+     * follows the same rules as the string constructor of `uintx`.
+     *
+     * @param s String to set the intx to.
+     * @param base The base of the string, from 2 to 36.
+     */
+    intx(const std::string& s, int base = 10): value(), negative(!s.empty() && s[0] == '-') {
+        const bool sign = !s.empty() && (s[0] == '-' || s[0] == '+');
+        value = magnitude_type(sign ? s.substr(1) : s, base);
+        normalize();
+    }
+
+    /**
+     * @brief Returns the absolute value.
+     */
+    const magnitude_type& magnitude() const noexcept {
+        return value;
+    }
+
+    /**
+     * @brief Checks if the value is less than 0.
+     */
+    bool is_negative() const noexcept {
+        return negative;
+    }
+
+    /**
+     * @brief Returns -1, 0 or 1 depending on the sign of the value.
+     */
+    int signum() const noexcept {
+        return negative ? -1 : value ? 1 : 0;
+    }
+
+    //@{
+    /**
+     * @brief Adds the contents of another intx.
+     * @details Adds the contents of another intx. When the signs differ
+     * the smaller magnitude is subtracted from the larger one in place.
+     *
+     * @param other The left hand side to add with.
+     */
+    intx& operator+=(const intx& other) {
+        accumulate(other, false);
+        return *this;
+    }
+
+    intx operator+(const intx& other) const & {
+        intx result(*this);
+        result += other;
+        return result;
+    }
+
+    intx operator+(const intx& other) && {
+        *this += other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Subtracts the contents of another intx.
+     * @details Subtracts the contents of another intx.
+     *
+     * @param other The left hand side to subtract with.
+     */
+    intx& operator-=(const intx& other) {
+        accumulate(other, true);
+        return *this;
+    }
+
+    intx operator-(const intx& other) const & {
+        intx result(*this);
+        result -= other;
+        return result;
+    }
+
+    intx operator-(const intx& other) && {
+        *this -= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Multiplies the contents of another intx.
+     * @details Multiplies the contents of another intx.
+     *
+     * @param other The left hand side to multiply with.
+     */
+    intx& operator*=(const intx& other) {
+        negative = negative != other.negative;
+        value *= other.value;
+        normalize();
+        return *this;
+    }
+
+    intx operator*(const intx& other) const & {
+        intx result(*this);
+        result *= other;
+        return result;
+    }
+
+    intx operator*(const intx& other) && {
+        *this *= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Divides the contents of another intx.
+     * @details Divides the contents of another intx. The quotient
+     * is truncated towards zero.
+     *
+     * @param other The left hand side to divide with.
+     * @throws std::logic_error Thrown if division by zero occurs.
+     */
+    intx& operator/=(const intx& other) {
+        negative = negative != other.negative;
+        value /= other.value;
+        normalize();
+        return *this;
+    }
+
+    intx operator/(const intx& other) const & {
+        intx result(*this);
+        result /= other;
+        return result;
+    }
+
+    intx operator/(const intx& other) && {
+        *this /= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Modulos the contents of another intx.
+     * @details Modulos the contents of another intx. The remainder
+     * has the sign of the dividend.
+     *
+     * @param other The left hand side to modulo with.
+     * @throws std::logic_error Thrown if modulo by zero occurs.
+     */
+    intx& operator%=(const intx& other) {
+        value %= other.value;
+        normalize();
+        return *this;
+    }
+
+    intx operator%(const intx& other) const & {
+        intx result(*this);
+        result %= other;
+        return result;
+    }
+
+    intx operator%(const intx& other) && {
+        *this %= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Negates the value.
+     */
+    intx operator-() const & {
+        intx result(*this);
+        result.negative = !negative;
+        result.normalize();
+        return result;
+    }
+
+    intx operator-() && {
+        negative = !negative;
+        normalize();
+        return std::move(*this);
+    }
+
+    intx operator+() const {
+        return *this;
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Logically compares two intx objects.
+     */
+    bool operator==(const intx& other) const {
+        return negative == other.negative && value == other.value;
+    }
+
+    bool operator!=(const intx& other) const {
+        return !(*this == other);
+    }
+
+    bool operator<(const intx& other) const {
+        if(negative != other.negative) {
+            return negative;
+        }
+        return negative ? other.value < value : value < other.value;
+    }
+
+    bool operator>(const intx& other) const {
+        return other < *this;
+    }
+
+    bool operator<=(const intx& other) const {
+        return !(other < *this);
+    }
+
+    bool operator>=(const intx& other) const {
+        return !(*this < other);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Increments an intx object by one.
+     */
+    intx operator++(int) {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    const intx& operator++() {
+        if(negative) {
+            --value;
+            normalize();
+        }
+        else {
+            ++value;
+        }
+        return *this;
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Decrements an intx object by one.
+     */
+    intx operator--(int) {
+        auto copy = *this;
+        --*this;
+        return copy;
+    }
+
+    const intx& operator--() {
+        if(negative || !value) {
+            ++value;
+            negative = true;
+        }
+        else {
+            --value;
+        }
+        return *this;
+    }
+    //@}
+
+    /**
+     * @brief Checks if intx is not 0.
+     * @return `true` if the internal value is not 0, `false` otherwise.
+     */
+    explicit operator bool() const noexcept {
+        return static_cast<bool>(value);
+    }
+
+    #ifndef GEARS_NO_IOSTREAM
+    template<typename Elem, typename Traits>
+    friend std::basic_ostream<Elem, Traits>& operator<<(std::basic_ostream<Elem, Traits>& out, const intx& n) {
+        if(n.negative) {
+            out << '-';
+        }
+        return out << n.value;
+    }
+
+    template<typename Elem, typename Traits>
+    friend std::basic_istream<Elem, Traits>& operator>>(std::basic_istream<Elem, Traits>& in, intx& n) {
+        std::string str;
+        in >> str;
+        n = str;
+        return in;
+    }
+
+    #endif // GEARS_NO_IOSTREAM
+};
+
+/**
+ * @brief Casts an intx to another type.
+ * @details Casts an intx to another type. This type can be an integer
+ * type, a floating point type or a string type. To cast to a string,
+ * `intx_cast<std::string>` must be used. If the value does not fit in
+ * an integer type it wraps around like a conversion between built-in
+ * integer types does.
+ *
+ * @param obj Object to cast.
+ * @tparam T Type to cast to.
+ * @return Casted value.
+ */
+template<typename T, size_t N, typename U, typename V>
+inline T intx_cast(const intx<N, U, V>& obj) {
+    return detail::signed_cast<T>()(obj.magnitude(), obj.is_negative());
+}
+
+/**
+ * @brief Computes the quotient and remainder at the same time.
+ * @details Computes the quotient and remainder of a division with a
+ * single pass over the magnitudes. The quotient is truncated towards
+ * zero and the remainder has the sign of the numerator.
+ *
+ * @param numerator The number to divide.
+ * @param denominator The number to divide by.
+ * @return A pair of the quotient and the remainder, in that order.
+ * @throws std::logic_error Thrown if division by zero occurs.
+ */
+template<size_t N, typename U, typename V>
+inline std::pair<intx<N, U, V>, intx<N, U, V>> divmod(const intx<N, U, V>& numerator, const intx<N, U, V>& denominator) {
+    auto result = divmod(numerator.magnitude(), denominator.magnitude());
+    return { intx<N, U, V>(std::move(result.first), numerator.is_negative() != denominator.is_negative()),
+             intx<N, U, V>(std::move(result.second), numerator.is_negative()) };
+}
+
+/**
+ * @brief Calculates the greatest common divisor of two intx.
+ * @details Calculates the greatest common divisor of the magnitudes with
+ * the same algorithm `gcd` uses for `uintx`. The result is never negative.
+ *
+ * @param lhs Left hand side.
+ * @param rhs Right hand side.
+ * @return The greatest common divisor, or 0 if both are 0.
+ */
+template<size_t N, typename U, typename V>
+inline intx<N, U, V> gcd(const intx<N, U, V>& lhs, const intx<N, U, V>& rhs) {
+    return intx<N, U, V>(gcd(lhs.magnitude(), rhs.magnitude()));
+}
+} // math
+} // gears
+
+#endif // GEARS_MATH_INTX_HPP
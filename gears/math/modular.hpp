@@ -0,0 +1,171 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef GEARS_MATH_MODULAR_HPP
+#define GEARS_MATH_MODULAR_HPP
+
+#include <type_traits>
+#include <utility>
+
+namespace gears {
+namespace math {
+namespace detail {
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 uint128;
+#endif
+
+// (lhs + rhs) % modulus for reduced operands, without overflowing
+template<typename T>
+inline T add_mod(const T& lhs, const T& rhs, const T& modulus) {
+    return lhs >= modulus - rhs ? T(lhs - (modulus - rhs)) : T(lhs + rhs);
+}
+
+// products that fit in an unsigned long long
+template<typename T>
+inline typename std::enable_if<(sizeof(T) <= sizeof(unsigned long long) / 2), T>::type
+unsigned_mul_mod(T lhs, T rhs, T modulus) noexcept {
+    return static_cast<T>(static_cast<unsigned long long>(lhs) * rhs % modulus);
+}
+
+// wider products use unsigned __int128 when the compiler has it, otherwise
+// the product is accumulated one bit at a time without ever overflowing
+template<typename T>
+inline typename std::enable_if<(sizeof(T) > sizeof(unsigned long long) / 2), T>::type
+unsigned_mul_mod(T lhs, T rhs, T modulus) noexcept {
+#if defined(__SIZEOF_INT128__)
+    if(sizeof(T) <= sizeof(unsigned long long)) {
+        return static_cast<T>(static_cast<uint128>(lhs) * rhs % modulus);
+    }
+#endif
+    T result(0);
+    lhs %= modulus;
+    rhs %= modulus;
+    while(rhs) {
+        if(rhs & 1) {
+            result = add_mod(result, lhs, modulus);
+        }
+        lhs = add_mod(lhs, lhs, modulus);
+        rhs >>= 1;
+    }
+    return result;
+}
+
+template<typename T>
+inline T mul_mod(const T& lhs, const T& rhs, const T& modulus, std::false_type) {
+    return (lhs * rhs) % modulus;
+}
+
+template<typename T>
+inline T mul_mod(T lhs, T rhs, T modulus, std::true_type) noexcept {
+    using unsigned_type = typename std::make_unsigned<T>::type;
+    return static_cast<T>(unsigned_mul_mod<unsigned_type>(lhs, rhs, modulus));
+}
+} // detail
+
+/**
+ * @ingroup math
+ * @brief Modular arithmetic with a fixed modulus.
+ * @details Modular arithmetic with a fixed modulus. A context is
+ * constructed once for a modulus and then reused for any number of
+ * operations with it, so types that benefit from precomputation can
+ * specialise it. The general version works with any type that provides
+ * the arithmetic operators and uses `operator%` after every product.
+ * Products of built-in integers are computed in a type twice as wide,
+ * `unsigned __int128` for 64-bit integers where available, so they
+ * never overflow.
+ *
+ * `uintx` specialises this template. It precomputes Barrett constants
+ * for `mul` and `sqr`, and uses Montgomery multiplication in `pow` when
+ * the modulus is odd.
+ *
+ * All operands must be non-negative.
+ *
+ * @tparam T The integer type to work with.
+ */
+template<typename T>
+class modular {
+private:
+    T m;
+public:
+    /**
+     * @brief Constructs a context for a modulus.
+     *
+     * @param modulus The modulus to reduce by. Must not be zero.
+     */
+    explicit modular(T modulus): m(std::move(modulus)) {}
+
+    /**
+     * @brief Returns the modulus of the context.
+     */
+    const T& modulus() const noexcept {
+        return m;
+    }
+
+    /**
+     * @brief Reduces a number by the modulus.
+     */
+    T reduce(const T& value) const {
+        return value % m;
+    }
+
+    /**
+     * @brief Computes `(lhs * rhs) % modulus`.
+     */
+    T mul(const T& lhs, const T& rhs) const {
+        return detail::mul_mod(lhs, rhs, m, std::is_integral<T>());
+    }
+
+    /**
+     * @brief Computes `(value * value) % modulus`.
+     */
+    T sqr(const T& value) const {
+        return detail::mul_mod(value, value, m, std::is_integral<T>());
+    }
+
+    /**
+     * @brief Calculates the modular exponentiation.
+     * @details Calculates `(base ** exponent) % modulus` where `**`
+     * denotes exponentiation, by repeated squaring.
+     *
+     * @param base The base number of the formula.
+     * @param exponent The exponent number of the formula.
+     * @return `(base ** exponent) % modulus`.
+     */
+    T pow(T base, T exponent) const {
+        T result = T(1) % m;
+        base = base % m;
+
+        while(exponent) {
+            if((exponent % 2) == 1) {
+                result = mul(base, result);
+            }
+            exponent /= 2;
+            base = sqr(base);
+        }
+
+        return result;
+    }
+};
+} // math
+} // gears
+
+#endif // GEARS_MATH_MODULAR_HPP
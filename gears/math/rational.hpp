@@ -0,0 +1,324 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef GEARS_MATH_RATIONAL_HPP
+#define GEARS_MATH_RATIONAL_HPP
+
+#include <gears/math/algorithm.hpp>
+#include <stdexcept>
+#include <utility>
+
+#ifndef GEARS_NO_IOSTREAM
+#include <iosfwd>
+#endif // GEARS_NO_IOSTREAM
+
+namespace gears {
+namespace math {
+/**
+ * @ingroup math
+ * @brief Exact fraction of two integers.
+ * @details Exact fraction of two integers, usually `rational<intx<>>`,
+ * although any signed integer type works. The denominator is always kept
+ * positive.
+ *
+ * Arithmetic does not divide out the greatest common divisor after every
+ * operation, so a chain of operations pays for a single gcd instead of one
+ * per step. Comparisons cross multiply and never need a reduced fraction.
+ * `numerator`, `denominator` and the streaming operator return the reduced
+ * terms without modifying the fraction, so reading a `const rational` from
+ * several threads is safe, but each of them divides by the gcd again until
+ * `reduce` is called. Call `reduce` once a result is final, or to bound the
+ * size of the terms in long running computations.
+ *
+ * @tparam T The integer type of the numerator and denominator.
+ */
+template<typename T>
+struct rational {
+private:
+    T num;
+    T den;
+    bool reduced;
+
+    void fix_sign() {
+        if(!den) {
+            throw std::logic_error("Division by zero");
+        }
+
+        if(den < 0) {
+            num = -std::move(num);
+            den = -std::move(den);
+        }
+    }
+public:
+    /**
+     * @brief Default constructor.
+     * @details Sets the fraction to 0.
+     */
+    rational(): num(0), den(1), reduced(true) {}
+
+    /**
+     * @brief Constructs from an integer.
+     * @details Constructs the fraction `value / 1`.
+     *
+     * @param value The value of the fraction.
+     */
+    rational(T value): num(std::move(value)), den(1), reduced(true) {}
+
+    /**
+     * @brief Constructs from a numerator and a denominator.
+     * @details Constructs the fraction `numerator / denominator`. The
+     * fraction is reduced lazily.
+     *
+     * @param numerator The numerator.
+     * @param denominator The denominator.
+     * @throws std::logic_error Thrown if the denominator is 0.
+     */
+    rational(T numerator, T denominator): num(std::move(numerator)), den(std::move(denominator)), reduced(false) {
+        fix_sign();
+    }
+
+    /**
+     * @brief Divides the numerator and denominator by their greatest common divisor.
+     * @return A reference to the fraction.
+     */
+    rational& reduce() {
+        if(!reduced) {
+            const T divisor = gcd(abs(num), den);
+            if(divisor != 1) {
+                num /= divisor;
+                den /= divisor;
+            }
+            reduced = true;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns the numerator of the reduced fraction.
+     */
+    T numerator() const {
+        return reduced ? num : num / gcd(abs(num), den);
+    }
+
+    /**
+     * @brief Returns the denominator of the reduced fraction, which is always positive.
+     */
+    T denominator() const {
+        return reduced ? den : den / gcd(abs(num), den);
+    }
+
+    //@{
+    /**
+     * @brief Adds another fraction.
+     * @details Adds another fraction. Fractions with the same
+     * denominator only add their numerators.
+     *
+     * @param other The left hand side to add with.
+     */
+    rational& operator+=(const rational& other) {
+        if(den == other.den) {
+            num += other.num;
+        }
+        else {
+            num *= other.den;
+            num += other.num * den;
+            den *= other.den;
+        }
+        reduced = false;
+        return *this;
+    }
+
+    rational operator+(const rational& other) const & {
+        rational result(*this);
+        result += other;
+        return result;
+    }
+
+    rational operator+(const rational& other) && {
+        *this += other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Subtracts another fraction.
+     * @details Subtracts another fraction. Fractions with the same
+     * denominator only subtract their numerators.
+     *
+     * @param other The left hand side to subtract with.
+     */
+    rational& operator-=(const rational& other) {
+        if(den == other.den) {
+            num -= other.num;
+        }
+        else {
+            num *= other.den;
+            num -= other.num * den;
+            den *= other.den;
+        }
+        reduced = false;
+        return *this;
+    }
+
+    rational operator-(const rational& other) const & {
+        rational result(*this);
+        result -= other;
+        return result;
+    }
+
+    rational operator-(const rational& other) && {
+        *this -= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Multiplies by another fraction.
+     * @details Multiplies by another fraction.
+     *
+     * @param other The left hand side to multiply with.
+     */
+    rational& operator*=(const rational& other) {
+        num *= other.num;
+        den *= other.den;
+        reduced = false;
+        return *this;
+    }
+
+    rational operator*(const rational& other) const & {
+        rational result(*this);
+        result *= other;
+        return result;
+    }
+
+    rational operator*(const rational& other) && {
+        *this *= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Divides by another fraction.
+     * @details Divides by another fraction.
+     *
+     * @param other The left hand side to divide with.
+     * @throws std::logic_error Thrown if `other` is 0.
+     */
+    rational& operator/=(const rational& other) {
+        if(!other.num) {
+            throw std::logic_error("Division by zero");
+        }
+
+        if(this == &other) {
+            *this = rational(1);
+            return *this;
+        }
+
+        num *= other.den;
+        den *= other.num;
+        reduced = false;
+        fix_sign();
+        return *this;
+    }
+
+    rational operator/(const rational& other) const & {
+        rational result(*this);
+        result /= other;
+        return result;
+    }
+
+    rational operator/(const rational& other) && {
+        *this /= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Negates the fraction.
+     */
+    rational operator-() const {
+        rational result(*this);
+        result.num = -std::move(result.num);
+        return result;
+    }
+
+    rational operator+() const {
+        return *this;
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Compares two fractions by cross multiplication.
+     */
+    bool operator==(const rational& other) const {
+        return num * other.den == other.num * den;
+    }
+
+    bool operator!=(const rational& other) const {
+        return !(*this == other);
+    }
+
+    bool operator<(const rational& other) const {
+        return num * other.den < other.num * den;
+    }
+
+    bool operator>(const rational& other) const {
+        return other < *this;
+    }
+
+    bool operator<=(const rational& other) const {
+        return !(other < *this);
+    }
+
+    bool operator>=(const rational& other) const {
+        return !(*this < other);
+    }
+    //@}
+
+    /**
+     * @brief Checks if the fraction is not 0.
+     */
+    explicit operator bool() const {
+        return static_cast<bool>(num);
+    }
+
+    #ifndef GEARS_NO_IOSTREAM
+    template<typename Elem, typename Traits>
+    friend std::basic_ostream<Elem, Traits>& operator<<(std::basic_ostream<Elem, Traits>& out, const rational& r) {
+        rational reduced(r);
+        reduced.reduce();
+        if(reduced.den == 1) {
+            return out << reduced.num;
+        }
+        return out << reduced.num << '/' << reduced.den;
+    }
+    #endif // GEARS_NO_IOSTREAM
+};
+} // math
+} // gears
+
+#endif // GEARS_MATH_RATIONAL_HPP
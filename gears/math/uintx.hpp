@@ -27,7 +27,19 @@
 #include <vector>
 #include <string>
 #include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <system_error>
 #include <gears/meta/enable_if.hpp>
+#include <gears/meta/conditional.hpp>
+#include <gears/math/uintx/limbs.hpp>
+#include <gears/math/uintx/multiply.hpp>
+#include <gears/math/uintx/divide.hpp>
+#include <gears/math/uintx/storage.hpp>
+#include <gears/math/uintx/radix.hpp>
+#include <gears/math/uintx/modular.hpp>
+#include <gears/math/uintx/gcd.hpp>
+#include <gears/math/modular.hpp>
 
 #ifndef GEARS_NO_IOSTREAM
 #include <iosfwd>
@@ -40,64 +52,79 @@ constexpr size_t pow(size_t base, size_t exponent) {
     return exponent == 0 ? 1 : (base * pow(base, exponent - 1));
 }
 
-template<typename Cont>
-inline void reverse(Cont& c) {
-    auto first = std::begin(c);
-    auto last = std::end(c);
-
-    if(first == last)
-        return;
-    --last;
-    while(first < last) {
-        using std::swap;
-        swap(*first, *last);
-        ++first;
-        --last;
-    }
-}
-
-template<typename InIt, typename OutIt, typename UnaryF>
-inline OutIt map(InIt first, InIt last, OutIt result, UnaryF&& f) {
-    for(; first != last; ++first, ++result) {
-        *result = f(*first);
-    }
-    return result;
-}
-
-template<typename InIt, typename InIt2, typename OutIt, typename BinaryF>
-inline OutIt map(InIt first, InIt last, InIt2 start, OutIt result, BinaryF&& f) {
-    for (; first != last; ++first, ++start, ++result) {
-        *result = f(*first, *start);
-    }
-    return result;
-}
-
-template<typename T>
+template<typename T, typename Digits, bool = std::is_integral<T>::value>
 struct partial_cast {
-    template<typename U>
-    T operator()(const U& u, size_t base) const {
+    template<typename Digit>
+    T operator()(const Digit* u, size_t n) const {
         T result{};
-        for(int i = u.size() - 1; i >= 0; --i) {
-            result = result * base + u[i];
+        for(size_t i = n; i > 0; --i) {
+            result = static_cast<T>(shift_left(result, limb_bits<Digit>()) | u[i - 1]);
         }
         return result;
     }
 };
 
-template<>
-struct partial_cast<std::string> {
-    template<typename U>
-    std::string operator()(const U& u, size_t base) const {
-        unsigned long long x = 0;
-        for(int i = u.size() - 1; i >= 0; --i) {
-            x = x * base + u[i];
+template<typename T, typename Digits>
+struct partial_cast<T, Digits, false> {
+    template<typename Digit>
+    T operator()(const Digit* u, size_t n) const {
+        const T radix = static_cast<T>(Digits(1) << limb_bits<Digit>());
+        T result{};
+        for(size_t i = n; i > 0; --i) {
+            result = result * radix + u[i - 1];
         }
-        return std::to_string(x);
+        return result;
     }
 };
 
+template<typename Digits>
+struct partial_cast<std::string, Digits, false> {
+    template<typename Digit>
+    std::string operator()(const Digit* u, size_t n) const {
+        return to_radix_string<Digits>(u, n, 10);
+    }
+};
 } // detail
 
+/**
+ * @ingroup math
+ * @brief The result of `to_chars`.
+ * @details The result of `to_chars`. On success `ptr` is one past the last
+ * character written and `ec` is value-initialised. On failure `ptr` is the
+ * end of the buffer and `ec` is `std::errc::value_too_large`, or
+ * `std::errc::invalid_argument` for an unsupported base.
+ */
+struct to_chars_result {
+    char* ptr;
+    std::errc ec;
+};
+
+/**
+ * @ingroup math
+ * @brief The result of `from_chars`.
+ * @details The result of `from_chars`. On success `ptr` is one past the
+ * last digit parsed and `ec` is value-initialised. If no digits could be
+ * parsed `ptr` is the beginning of the input and `ec` is
+ * `std::errc::invalid_argument`. If the value does not fit in a bounded
+ * uintx `ec` is `std::errc::result_out_of_range`.
+ */
+struct from_chars_result {
+    const char* ptr;
+    std::errc ec;
+};
+
+template<size_t Bits, typename Digit, typename Digits>
+struct uintx;
+
+template<size_t Bits, typename Digit, typename Digits>
+struct intx;
+
+template<size_t N, typename U, typename V>
+to_chars_result to_chars(char* first, char* last, const uintx<N, U, V>& value, int base = 10);
+
+template<size_t N, typename U, typename V>
+from_chars_result from_chars(const char* first, const char* last, uintx<N, U, V>& value, int base = 10);
+
 /**
  * @ingroup math
  * @brief Multi-precision unsigned integer.
@@ -106,17 +133,48 @@ struct partial_cast<std::string> {
  * for memory optimisations on rare cases when necessary. Both types should be
  * unsigned if provided.
  *
- * This multi-precision integer overloads all mathematical operators except the
- * bitwise operators. The streaming operators `operator<<` and `operator>>` are
+ * The value is stored in binary as an array of Digit limbs, least significant
+ * limb first. Digits must be at least twice as wide as Digit since it holds the
+ * full result of a limb sum or product, with the carry taken from its high half.
+ * The default uses 32-bit limbs. On compilers that provide `unsigned __int128`,
+ * 64-bit limbs can be used through `uintx<-1, unsigned long long, unsigned __int128>`.
+ * Conversion to and from text only happens when a string is involved. Any
+ * base from 2 to 36 is supported through the string constructor, `to_chars`
+ * and `from_chars`, and the streaming operators honour `std::hex` and
+ * `std::oct`. Large values are converted by splitting them in halves, so the
+ * cost is close to that of a multiplication rather than quadratic. The size
+ * in limbs below which the quadratic method is used can be tuned by defining
+ * `GEARS_UINTX_RADIX_THRESHOLD`.
+ *
+ * Multiplication switches from the schoolbook method to Karatsuba, Toom-3 and
+ * finally a number theoretic transform as the operands grow. The switching
+ * points, in limbs, can be tuned by defining `GEARS_UINTX_KARATSUBA_THRESHOLD`,
+ * `GEARS_UINTX_TOOM3_THRESHOLD` and `GEARS_UINTX_NTT_THRESHOLD` before including
+ * the file. Squares of at least `GEARS_UINTX_SQR_THRESHOLD` limbs compute each
+ * cross product only once. Division uses Knuth's algorithm D and moves to multiplication by a
+ * Newton reciprocal once both the divisor and quotient reach
+ * `GEARS_UINTX_NEWTON_THRESHOLD` limbs. Use `divmod` when both the quotient
+ * and the remainder are needed.
+ *
+ * This multi-precision integer overloads all mathematical and bitwise operators.
+ * Bitwise operators work on the binary limbs directly. Since an unbounded
+ * integer has no fixed width, `operator~` is only available when the precision
+ * is bounded. The streaming operators `operator<<` and `operator>>` are
  * provided as well. In order to disable the streaming operators, define
  * `GEARS_NO_IOSTREAM` before including the file.
  *
  * All operations do a "bit-check" after their operations to see if the result
- * fits in the bits provided. The "bit-check" in reality just truncates the result
- * to however many digits can fit under `Bits / (sizeof(Digit) * 8)`. It is unclear
- * if this behaviour should change at the moment although it might in the future.
+ * fits in the bits provided. The "bit-check" truncates the result to its lowest
+ * `Bits` bits, so bounded integers wrap around like the built-in unsigned types.
  * A Bits parameter of `-1` will avoid the "bit-check".
  *
+ * Bounded integers of up to `GEARS_UINTX_MAX_INLINE_BITS` bits (4096 unless
+ * defined before including the file) keep their limbs in an inline array
+ * instead of the heap. They are trivially copyable and can be constructed
+ * from an integer in a constant expression. Other integers keep up to
+ * `GEARS_UINTX_SMALL_LIMBS` limbs (4 by default) inline and only allocate
+ * once a value grows past that, so copying and moving small values is cheap.
+ *
  * There are two user-defined literals provided under `gears::math::literals` help
  * with the construction of a `uintx<>`. An example is provided below.
  *
@@ -128,212 +186,231 @@ struct partial_cast<std::string> {
  * @endcode
  *
  * @tparam Bits Bits of precision needed. Defaults to -1 for "infinite" precision.
- * @tparam Digit Underlying type to store its bit properties.
- * @tparam Digits Underlying type to store its numeric properties.
+ * @tparam Digit Underlying type of a single limb.
+ * @tparam Digits Underlying type used to hold the result of two limbs.
  */
 template<size_t Bits = static_cast<size_t>(-1), typename Digit = unsigned int, typename Digits = unsigned long long>
 struct uintx {
 private:
-    using signed_type = gears::meta::eval<std::make_signed<Digits>>;
-    static constexpr size_t digit_bits = sizeof(Digits) * 8;
-    static constexpr size_t digit_count = Bits == size_t(-1) ? size_t(-1) : (Bits / digit_bits);
+    static_assert(std::is_unsigned<Digit>::value, "Digit must be an unsigned integer type");
+    static_assert(sizeof(Digits) >= 2 * sizeof(Digit), "Digits must be at least twice as wide as Digit");
+    static constexpr size_t digit_bits = detail::limb_bits<Digit>();
+    static constexpr size_t digit_count = Bits == size_t(-1) ? size_t(-1) : (Bits + digit_bits - 1) / digit_bits;
+    static constexpr size_t top_bits = Bits == size_t(-1) ? 0 : Bits % digit_bits;
+    static constexpr Digit top_mask = top_bits == 0 ? Digit(~Digit(0)) : Digit((Digit(1) << top_bits) - 1);
     static_assert(digit_count, "Invalid bits parameter. Note: Use -1 for \"infinite\" precision");
+    static constexpr bool inline_storage = Bits != size_t(-1) && Bits <= GEARS_UINTX_MAX_INLINE_BITS;
 
-    std::vector<Digits> digits;
-
-    struct add {
-        Digits operator()(Digits a, Digits b) {
-            return a + b;
-        }
-    };
+    using storage_type = gears::meta::iif<gears::meta::boolean<inline_storage>,
+                                          detail::fixed_storage<Digit, inline_storage ? digit_count : 1, top_mask>,
+                                          detail::dynamic_storage<Digit>>;
+    using scratch_type = detail::scratch_buffer<Digit, inline_storage ? 2 * digit_count + 1 : 0>;
 
-    struct multiply {
-        Digits k;
-        multiply() = default;
-        multiply(Digits n): k(n) {}
+    storage_type digits;
 
-        Digits operator()(Digits a) {
-            return a * k;
+    void normalize() {
+        while(!digits.empty() && digits.back() == 0) {
+            digits.pop_back();
         }
-    };
-
-    struct carry {
-        Digits& c;
-        carry(Digits& a): c(a) {}
-
-        Digits operator()(Digits n) {
-            n += c;
-            c = n / base;
-            n %= base;
+    }
 
-            return n;
+    void check_bits() {
+        if(Bits != size_t(-1) && digits.size() >= digit_count) {
+            digits.resize(digit_count);
+            digits.back() &= top_mask;
         }
-    };
-
-    template<class Base>
-    struct operator_carry : public Base, public carry {
-        operator_carry(Digits& c): carry(c) {}
+        normalize();
+    }
 
-        Digits operator()(Digits a) {
-            return carry::operator()(Base::operator()(a));
+    static void divide(const uintx& numerator, const uintx& denominator, uintx* quotient, uintx* remainder) {
+        if(!denominator) {
+            throw std::logic_error("Division by zero");
         }
 
-        Digits operator()(Digits a, Digits b) {
-            return carry::operator()(Base::operator()(a, b));
-        }
-    };
+        auto first_size = numerator.digits.size();
+        auto second_size = denominator.digits.size();
 
-    struct borrow {
-        signed_type& b;
-        borrow(signed_type& b): b(b) {}
+        if(first_size < second_size) {
+            if(remainder) {
+                *remainder = numerator;
+            }
 
-        signed_type operator()(signed_type n) {
-            n -= b;
-            b = 0;
-            while(n < 0) {
-                n += base;
-                ++b;
+            if(quotient) {
+                quotient->digits.clear();
             }
-            return n;
+            return;
         }
-    };
-
-    struct sub_borrow {
-        signed_type& borrow;
-        sub_borrow(signed_type& b): borrow(b) {}
 
-        Digits operator()(signed_type a, signed_type b) {
-            signed_type n = b - a - borrow;
-            borrow = 0;
-            while(n < 0) {
-                n += base;
-                ++borrow;
-            }
-            return n;
+        storage_type q;
+        storage_type r;
+        scratch_type scratch(first_size + second_size + 1);
+        q.resize(first_size - second_size + 1);
+        r.resize(second_size);
+        detail::divrem<Digits>(q.data(), r.data(), numerator.digits.data(), first_size,
+                               denominator.digits.data(), second_size, scratch.data());
+
+        if(quotient) {
+            quotient->digits.swap(q);
+            quotient->normalize();
         }
-    };
 
-    void normalize() {
-        while(digits.size() > 1) {
-            if(digits.back() == 0)
-                digits.pop_back();
-            else
-                break;
+        if(remainder) {
+            remainder->digits.swap(r);
+            remainder->normalize();
         }
     }
 
-    void add_zeroes(Digits n) {
-        digits.resize(digits.size() + n);
-        digits.insert(digits.begin(), n, 0);
+    // *this = other - *this in place, requires other >= *this
+    void subtract_from(const uintx& other) {
+        const size_t size = digits.size();
+        digits.resize(other.digits.size());
+        detail::sub<Digits>(digits.data(), other.digits.data(), other.digits.size(), digits.data(), size);
+        normalize();
     }
 
-    void check_bits() {
-        if(digit_count == Bits)
-            return;
-        if(digits.capacity() >= digit_count)
-            digits.resize(digit_count);
+    void assign(const std::vector<Digit>& limbs) {
+        digits.resize(limbs.size());
+        for(size_t i = 0; i < digits.size(); ++i) {
+            digits[i] = limbs[i];
+        }
+        check_bits();
     }
 
-    void multiply_helper(uintx& x, Digits digit) {
-        Digits c = 0;
-        operator_carry<multiply> mulwc(c);
-        mulwc.k = digit;
-        detail::map(x.digits.begin(), x.digits.end(), x.digits.begin(), mulwc);
+    // out = first * second, truncated to the limbs bounded precision keeps.
+    // out must not alias either operand.
+    static void multiply(storage_type& out, const uintx& lhs, const uintx& rhs) {
+        const uintx* first = &lhs;
+        const uintx* second = &rhs;
+
+        auto first_size = first->digits.size();
+        auto second_size = second->digits.size();
+
+        if(first_size == 0 || second_size == 0) {
+            out.clear();
+            return;
+        }
 
-        while(c) {
-            x.digits.push_back(c % base);
-            c /= base;
+        if(first_size < second_size) {
+            using std::swap;
+            swap(first, second);
+            swap(first_size, second_size);
         }
 
-        x.normalize();
-        x.check_bits();
+        if(inline_storage && first_size + second_size > digit_count) {
+            out.resize(digit_count);
+            detail::mul_low<Digits>(out.data(), digit_count, first->digits.data(), first_size, second->digits.data(), second_size);
+        }
+        else {
+            out.resize(first_size + second_size);
+            detail::mul<Digits>(out.data(), first->digits.data(), first_size, second->digits.data(), second_size);
+        }
     }
 
-    Digit divide_helper(const uintx& remainder, const uintx& denominator) {
-        Digit minimum = 0;
-        Digit maximum = base - 1;
-        while(maximum - minimum > 0) {
-            Digit total = maximum + minimum;
-            Digit half_total = total / 2;
-            total = total - half_total * 2 ? half_total + 1 : half_total;
-            auto product = denominator * total;
-            if(product == remainder) {
-                return total;
-            }
+    // result += lhs * rhs or result -= lhs * rhs. A single limb factor is
+    // folded straight into result without building the product.
+    static void fused(uintx& result, const uintx& lhs, const uintx& rhs, bool subtract) {
+        const uintx* first = &lhs;
+        const uintx* second = &rhs;
+        if(first->digits.size() < second->digits.size()) {
+            using std::swap;
+            swap(first, second);
+        }
 
-            if(remainder > product) {
-                minimum = total;
+        if(second->digits.empty()) {
+            return;
+        }
+
+        if(second->digits.size() > 1) {
+            uintx product;
+            multiply(product.digits, lhs, rhs);
+            product.check_bits();
+            if(subtract) {
+                result -= product;
             }
             else {
-                maximum = total - 1;
+                result += product;
             }
+            return;
         }
 
-        return minimum;
+        const Digit factor = second->digits[0];
+        size_t size = first->digits.size() + 1;
+        size = size < result.digits.size() ? result.digits.size() : size;
+        size = inline_storage && size > digit_count ? digit_count : size;
+        const size_t n = first->digits.size() < size ? first->digits.size() : size;
+        result.digits.resize(size);
+
+        Digit* out = result.digits.data();
+        if(subtract) {
+            Digit borrow = detail::submul_1<Digits>(out, first->digits.data(), n, factor);
+            borrow = n < size ? detail::sub_1<Digits>(out + n, size - n, borrow) : borrow;
+            if(borrow && Bits != size_t(-1)) {
+                result.digits.resize(digit_count, Digit(~Digit(0)));
+            }
+        }
+        else {
+            Digit carry = detail::addmul_1<Digits>(out, first->digits.data(), n, factor);
+            carry = n < size ? detail::add_1<Digits>(out + n, size - n, carry) : carry;
+            if(carry) {
+                result.digits.push_back(carry);
+            }
+        }
+        result.check_bits();
     }
 
     template<typename T>
-    typename std::enable_if<std::is_signed<T>::value, T>::type make_positive(T value) {
-        return value < 0 ? -value : value;
+    static constexpr typename std::enable_if<std::is_signed<T>::value, gears::meta::eval<std::make_unsigned<T>>>::type make_positive(T value) {
+        return value < 0 ? gears::meta::eval<std::make_unsigned<T>>(0) - static_cast<gears::meta::eval<std::make_unsigned<T>>>(value)
+                         : static_cast<gears::meta::eval<std::make_unsigned<T>>>(value);
     }
 
     template<typename T>
-    typename std::enable_if<std::is_unsigned<T>::value, T>::type make_positive(T value) {
+    static constexpr typename std::enable_if<std::is_unsigned<T>::value, T>::type make_positive(T value) {
         return value;
     }
 public:
+    /**
+     * @brief The number of decimal digits converted per limb at a time when
+     * converting to and from strings.
+     */
     static constexpr size_t digits10 = std::numeric_limits<Digit>::digits10;
-    static constexpr size_t base = detail::pow(10, digits10);
 
     /**
      * @brief Default constructor.
      * @details Sets uintx to 0.
      */
-    uintx(): digits(0) {}
+    constexpr uintx() noexcept: digits() {}
 
     /**
      * @brief Constructs from an integer.
      * @details Constructs uintx from an integer type. uintx is then
-     * set to the value provided. No bit-checking is done in this constructor.
-     * If the value is negative, then it is made positive before hand.
+     * set to the value provided. If the value is negative, then it is made
+     * positive before hand. Bit-checking is done in this constructor. When
+     * the precision is bounded this constructor is `constexpr`.
      *
      * @param value Value to set uintx to.
      */
     template<typename Integer, gears::meta::enable_if_t<std::is_integral<Integer>> = gears::meta::_>
-    uintx(Integer value) {
-        value = make_positive(value);
-        do {
-            digits.push_back(value % base);
-            value /= base;
-        }
-        while(value > 0);
-    }
+    constexpr uintx(Integer value): digits(make_positive(value)) {}
 
     /**
      * @brief Constructs from a string.
      * @details Constructs uintx from a string type. uintx is then
-     * set to the value provided from the string. If the string contains
-     * letters or special characters, the behaviour is undefined. The string
-     * must not represent a negative integer. Bit-checking is done in this
-     * constructor.
+     * set to the value provided from the string, written in the given
+     * base. Digits past 9 are the letters `a` to `z` in either case. If
+     * the string contains characters that are not digits of the base,
+     * the behaviour is undefined. The string must not represent a
+     * negative integer. Bit-checking is done in this constructor. Use
+     * `from_chars` to parse strings that need to be validated.
      *
      * @param s String to set the uintx to.
+     * @param base The base of the string, from 2 to 36.
      */
-    uintx(const std::string& s) {
-        size_t count = digits10 - (s.size() % digits10);
-        std::string str(count, '0');
-        str += s;
-        digits.reserve(str.size() / digits10 + 1);
-        auto size = str.size();
-        size_t position = 0;
-
-        while(position != size) {
-            digits.push_back(std::stoull(str.substr(position, digits10)));
-            position += digits10;
-        }
-
-        detail::reverse(digits);
-        check_bits();
+    uintx(const std::string& s, int base = 10) {
+        detail::radix<Digit> r(static_cast<unsigned>(base));
+        std::vector<Digit> limbs;
+        detail::from_radix<Digits>(limbs, s.data(), s.size(), r);
+        assign(limbs);
     }
 
     //@{
@@ -348,23 +425,24 @@ public:
             digits.resize(other.digits.size());
         }
 
-        Digits c = 0;
-        operator_carry<add> addwc(c);
-
-        auto it = detail::map(other.digits.begin(), other.digits.end(), digits.begin(), digits.begin(), addwc);
-        detail::map(it, digits.end(), it, carry(c));
+        Digit carry = detail::add<Digits>(digits.data(), digits.data(), digits.size(), other.digits.data(), other.digits.size());
 
-        if(c)
-            digits.push_back(c);
+        if(carry)
+            digits.push_back(carry);
 
-        normalize();
         check_bits();
         return *this;
     }
 
-    uintx operator+(const uintx& other) const {
+    uintx operator+(const uintx& other) const & {
         uintx result(*this);
-        return (result += other);
+        result += other;
+        return result;
+    }
+
+    uintx operator+(const uintx& other) && {
+        *this += other;
+        return std::move(*this);
     }
     //@}
 
@@ -373,22 +451,35 @@ public:
      * @brief Subtracts the contents of another uintx.
      * @details Subtracts the contents of another uintx. If the
      * result would end up being a negative value, the behaviour
-     * is undefined.
+     * is undefined unless the precision is bounded, in which case
+     * the result wraps around modulo 2<sup>Bits</sup>.
      *
      * @param other The left hand side to subtract with.
      */
     uintx& operator-=(const uintx& other) {
-        signed_type b = 0;
-        auto it = detail::map(other.digits.begin(), other.digits.end(), digits.begin(), digits.begin(), sub_borrow(b));
-        detail::map(it, digits.end(), it, borrow(b));
-        normalize();
+        if(digits.size() < other.digits.size()) {
+            digits.resize(other.digits.size());
+        }
+
+        Digit borrow = detail::sub<Digits>(digits.data(), digits.data(), digits.size(), other.digits.data(), other.digits.size());
+
+        if(borrow && Bits != size_t(-1)) {
+            digits.resize(digit_count, Digit(~Digit(0)));
+        }
+
         check_bits();
         return *this;
     }
 
-    uintx operator-(const uintx& other) const {
+    uintx operator-(const uintx& other) const & {
         uintx result(*this);
-        return (result -= other);
+        result -= other;
+        return result;
+    }
+
+    uintx operator-(const uintx& other) && {
+        *this -= other;
+        return std::move(*this);
     }
     //@}
 
@@ -400,109 +491,281 @@ public:
      * @param other The left hand side to multiply with.
      */
     uintx& operator*=(const uintx& other) {
-        const uintx* first = this;
-        const uintx* second = &other;
+        storage_type result;
+        multiply(result, *this, other);
+        digits.swap(result);
+        check_bits();
+        return *this;
+    }
 
-        auto first_size = first->digits.size();
-        auto second_size = second->digits.size();
+    uintx operator*(const uintx& other) const & {
+        uintx result(*this);
+        result *= other;
+        return result;
+    }
 
-        if(first_size < second_size) {
-            using std::swap;
-            swap(first, second);
-            swap(first_size, second_size);
+    uintx operator*(const uintx& other) && {
+        *this *= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Divides the contents of another uintx.
+     * @details Divides the contents of another uintx.
+     *
+     * @throws std::logic_error Thrown when division by zero occurs.
+     * @param other The left hand side to divide with.
+     */
+    uintx& operator/=(const uintx& other) {
+        divide(*this, other, this, nullptr);
+        return *this;
+    }
+
+    uintx operator/(const uintx& other) const & {
+        uintx result(*this);
+        result /= other;
+        return result;
+    }
+
+    uintx operator/(const uintx& other) && {
+        *this /= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Implements modulo arithmetic.
+     * @details Implements modulo arithmetic.
+     *
+     * @throws std::logic_error Thrown when division by zero occurs.
+     * @param other The left hand side to use modulus on.
+     */
+    uintx& operator%=(const uintx& other) {
+        divide(*this, other, nullptr, this);
+        return *this;
+    }
+
+    uintx operator%(const uintx& other) const & {
+        uintx result(*this);
+        result %= other;
+        return result;
+    }
+
+    uintx operator%(const uintx& other) && {
+        *this %= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Computes the bitwise AND with another uintx.
+     * @details Computes the bitwise AND with another uintx.
+     *
+     * @param other The left hand side to use.
+     */
+    uintx& operator&=(const uintx& other) {
+        if(digits.size() > other.digits.size()) {
+            digits.resize(other.digits.size());
         }
 
-        std::vector<uintx> ints(second_size);
+        for(size_t i = 0; i < digits.size(); ++i) {
+            digits[i] &= other.digits[i];
+        }
+
+        normalize();
+        return *this;
+    }
+
+    uintx operator&(const uintx& other) const & {
+        uintx result(*this);
+        result &= other;
+        return result;
+    }
 
-        for(unsigned i = 0; i < second_size; ++i) {
-            ints[i].digits = first->digits;
-            multiply_helper(ints[i], second->digits[i]);
+    uintx operator&(const uintx& other) && {
+        *this &= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Computes the bitwise OR with another uintx.
+     * @details Computes the bitwise OR with another uintx.
+     *
+     * @param other The left hand side to use.
+     */
+    uintx& operator|=(const uintx& other) {
+        if(digits.size() < other.digits.size()) {
+            digits.resize(other.digits.size());
         }
 
-        *this = ints.front();
-        digits.resize(first_size + second_size);
+        for(size_t i = 0; i < other.digits.size(); ++i) {
+            digits[i] |= other.digits[i];
+        }
+        return *this;
+    }
 
-        for(unsigned i = 1; i < second_size; ++i) {
-            ints[i].add_zeroes(i);
-            *this += ints[i];
+    uintx operator|(const uintx& other) const & {
+        uintx result(*this);
+        result |= other;
+        return result;
+    }
+
+    uintx operator|(const uintx& other) && {
+        *this |= other;
+        return std::move(*this);
+    }
+    //@}
+
+    //@{
+    /**
+     * @brief Computes the bitwise XOR with another uintx.
+     * @details Computes the bitwise XOR with another uintx.
+     *
+     * @param other The left hand side to use.
+     */
+    uintx& operator^=(const uintx& other) {
+        if(digits.size() < other.digits.size()) {
+            digits.resize(other.digits.size());
+        }
+
+        for(size_t i = 0; i < other.digits.size(); ++i) {
+            digits[i] ^= other.digits[i];
         }
 
         normalize();
-        check_bits();
         return *this;
     }
 
-    uintx operator*(const uintx& other) const {
+    uintx operator^(const uintx& other) const & {
         uintx result(*this);
-        return (result *= other);
+        result ^= other;
+        return result;
+    }
+
+    uintx operator^(const uintx& other) && {
+        *this ^= other;
+        return std::move(*this);
     }
     //@}
 
+    /**
+     * @brief Computes the bitwise complement.
+     * @details Computes the bitwise complement of all `Bits` bits. This
+     * is only available when the precision is bounded.
+     */
+    uintx operator~() const {
+        static_assert(Bits != size_t(-1), "The complement of an unbounded uintx is not representable");
+        uintx result(*this);
+        result.digits.resize(digit_count);
+        for(size_t i = 0; i < digit_count; ++i) {
+            result.digits[i] = static_cast<Digit>(~result.digits[i]);
+        }
+        result.check_bits();
+        return result;
+    }
+
     //@{
     /**
-     * @brief Divides the contents of another uintx.
-     * @details Divides the contents of another uintx.
+     * @brief Shifts the bits to the left.
+     * @details Shifts the bits to the left, which multiplies by
+     * 2<sup>shift</sup>. Bits shifted past `Bits` are discarded
+     * when the precision is bounded.
      *
-     * @throws std::logic_error Thrown when division by zero occurs.
-     * @param other The left hand side to divide with.
+     * @param shift The number of bits to shift by.
      */
-    uintx& operator/=(const uintx& other) {
-        if(other == 0)
-            throw std::logic_error("Division by zero");
+    uintx& operator<<=(size_t shift) {
+        const size_t n = digits.size();
+        const size_t limbs = shift / digit_bits;
+        const unsigned rest = shift % digit_bits;
+        if(n == 0 || shift == 0) {
+            return *this;
+        }
 
-        uintx remainder;
-        auto copy = digits;
-        digits.clear();
-        digits.resize(copy.size(), 0);
-        remainder.digits.reserve(digits.size());
-        for(int i = digits.size() - 1; i >= 0; --i) {
-            remainder.add_zeroes(1);
-            remainder.digits[0] = copy[i];
-            remainder.normalize();
-            Digit count = divide_helper(remainder, other);
-            remainder -= other * count;
-            digits[i] += count;
+        if(Bits != size_t(-1) && limbs >= digit_count) {
+            digits.clear();
+            return *this;
+        }
+
+        digits.resize(n + limbs + 1);
+        Digit* out = digits.data();
+        // going from the top down only reads limbs that were not written yet
+        for(size_t i = digits.size(); i > limbs;) {
+            --i;
+            const size_t j = i - limbs;
+            Digit value = j < n ? static_cast<Digit>(out[j] << rest) : Digit(0);
+            if(rest && j > 0 && j - 1 < n) {
+                value = static_cast<Digit>(value | (out[j - 1] >> (digit_bits - rest)));
+            }
+            out[i] = value;
+        }
+
+        for(size_t i = 0; i < limbs; ++i) {
+            out[i] = 0;
         }
 
-        normalize();
         check_bits();
         return *this;
     }
 
-    uintx operator/(const uintx& other) const {
+    uintx operator<<(size_t shift) const & {
         uintx result(*this);
-        return (result /= other);
+        result <<= shift;
+        return result;
+    }
+
+    uintx operator<<(size_t shift) && {
+        *this <<= shift;
+        return std::move(*this);
     }
     //@}
 
     //@{
     /**
-     * @brief Implements modulo arithmetic.
-     * @details Implements modulo arithmetic.
+     * @brief Shifts the bits to the right.
+     * @details Shifts the bits to the right, which divides by
+     * 2<sup>shift</sup> and rounds down.
      *
-     * @throws std::logic_error Thrown when division by zero occurs.
-     * @param other The left hand side to use modulus on.
+     * @param shift The number of bits to shift by.
      */
-    uintx& operator%=(const uintx& other) {
-        if(other == 0)
-            throw std::logic_error("Division by zero");
+    uintx& operator>>=(size_t shift) {
+        const size_t n = digits.size();
+        const size_t limbs = shift / digit_bits;
+        const unsigned rest = shift % digit_bits;
+        if(limbs >= n) {
+            digits.clear();
+            return *this;
+        }
 
-        auto copy = digits;
-        digits.clear();
-        for(int i = copy.size() - 1; i >= 0; --i) {
-            add_zeroes(1);
-            digits[0] = copy[i];
-            normalize();
-            *this -= other * divide_helper(*this, other);
+        Digit* out = digits.data();
+        if(rest) {
+            detail::rshift(out, out + limbs, n - limbs, rest);
+        }
+        else {
+            for(size_t i = 0; i < n - limbs; ++i) {
+                out[i] = out[i + limbs];
+            }
         }
+
+        digits.resize(n - limbs);
         normalize();
-        check_bits();
         return *this;
     }
 
-    uintx operator%(const uintx& other) const {
+    uintx operator>>(size_t shift) const & {
         uintx result(*this);
-        return (result %= other);
+        result >>= shift;
+        return result;
+    }
+
+    uintx operator>>(size_t shift) && {
+        *this >>= shift;
+        return std::move(*this);
     }
     //@}
 
@@ -519,28 +782,11 @@ public:
     }
 
     bool operator<(const uintx& other) const {
-        auto i = digits.size();
-
-        if(i < other.digits.size())
-            return true;
-        if(other.digits.size() < i)
-            return false;
-
-        --i;
-
-        do {
-            if(digits[i] < other.digits[i])
-                return true;
-            if(other.digits[i] < digits[i])
-                return false;
-            --i;
-        } while (i > 0);
-
-        return false;
+        return detail::compare(digits.data(), digits.size(), other.digits.data(), other.digits.size()) < 0;
     }
 
     bool operator>(const uintx& other) const {
-        return !(*this < other);
+        return other < *this;
     }
 
     bool operator<=(const uintx& other) const {
@@ -558,12 +804,15 @@ public:
      */
     uintx operator++(int) {
         auto copy = *this;
-        *this += 1;
+        ++*this;
         return copy;
     }
 
     const uintx& operator++() {
-        *this += 1;
+        if(detail::add_1<Digits>(digits.data(), digits.size(), Digit(1))) {
+            digits.push_back(1);
+        }
+        check_bits();
         return *this;
     }
     //@}
@@ -573,16 +822,22 @@ public:
      * @brief Decrements a uintx by one.
      * @details Decrements a uintx by one.
      * If the value ends up being negative, the
-     * behaviour is undefined.
+     * behaviour is undefined unless the precision
+     * is bounded, in which case it wraps around.
      */
     uintx operator--(int) {
         auto copy = *this;
-        *this -= 1;
+        --*this;
         return copy;
     }
 
     const uintx& operator--() {
-        *this -= 1;
+        if(detail::sub_1<Digits>(digits.data(), digits.size(), Digit(1)) || digits.empty()) {
+            if(Bits != size_t(-1)) {
+                digits.resize(digit_count, Digit(~Digit(0)));
+            }
+        }
+        check_bits();
         return *this;
     }
     //@}
@@ -593,22 +848,22 @@ public:
      * @return `true` if the internal value is greater than 0, `false` otherwise.
      */
     explicit operator bool() const noexcept {
-        return digits.back() > 0;
+        return !digits.empty();
     }
 
     #ifndef GEARS_NO_IOSTREAM
     template<typename Elem, typename Traits>
     friend std::basic_ostream<Elem, Traits>& operator<<(std::basic_ostream<Elem, Traits>& out, const uintx& n) {
-        auto first = n.digits.crbegin();
-        auto last = n.digits.crend();
-        if(first != last)
-            out << *first++;
-        while(first != last) {
-            out.fill('0');
-            out.width(uintx::digits10);
-            out << *first++;
+        using stream = std::basic_ostream<Elem, Traits>;
+        const auto basefield = out.flags() & stream::basefield;
+        const unsigned base = basefield == stream::hex ? 16 : basefield == stream::oct ? 8 : 10;
+        auto str = detail::to_radix_string<Digits>(n.digits.data(), n.digits.size(), base);
+        if(out.flags() & stream::uppercase) {
+            for(auto&& c : str) {
+                c = static_cast<char>(c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c);
+            }
         }
-        return out;
+        return out << str.c_str();
     }
 
     template<typename Elem, typename Traits>
@@ -623,6 +878,45 @@ public:
 
     template<typename T, size_t N, typename U, typename V>
     friend T uintx_cast(const uintx<N, U, V>& obj);
+
+    template<typename T>
+    friend class modular;
+
+    template<size_t N, typename U, typename V>
+    friend struct intx;
+
+    template<size_t N, typename U, typename V>
+    friend size_t popcount(const uintx<N, U, V>& value) noexcept;
+
+    template<size_t N, typename U, typename V>
+    friend size_t bit_length(const uintx<N, U, V>& value) noexcept;
+
+    template<size_t N, typename U, typename V>
+    friend size_t countr_zero(const uintx<N, U, V>& value) noexcept;
+
+    template<size_t N, typename U, typename V>
+    friend bool test_bit(const uintx<N, U, V>& value, size_t bit) noexcept;
+
+    template<size_t N, typename U, typename V>
+    friend to_chars_result to_chars(char* first, char* last, const uintx<N, U, V>& value, int base);
+
+    template<size_t N, typename U, typename V>
+    friend from_chars_result from_chars(const char* first, const char* last, uintx<N, U, V>& value, int base);
+
+    template<size_t N, typename U, typename V>
+    friend std::pair<uintx<N, U, V>, uintx<N, U, V>> divmod(const uintx<N, U, V>& numerator, const uintx<N, U, V>& denominator);
+
+    template<size_t N, typename U, typename V>
+    friend uintx<N, U, V>& add_mul(uintx<N, U, V>& result, const uintx<N, U, V>& lhs, const uintx<N, U, V>& rhs);
+
+    template<size_t N, typename U, typename V>
+    friend uintx<N, U, V>& sub_mul(uintx<N, U, V>& result, const uintx<N, U, V>& lhs, const uintx<N, U, V>& rhs);
+
+    template<size_t N, typename U, typename V>
+    friend uintx<N, U, V> gcd(const uintx<N, U, V>& lhs, const uintx<N, U, V>& rhs);
+
+    template<size_t N, typename U, typename V>
+    friend uintx<N, U, V> fma(const uintx<N, U, V>& lhs, const uintx<N, U, V>& rhs, const uintx<N, U, V>& addend);
 };
 
 /**
@@ -638,9 +932,493 @@ public:
  */
 template<typename T, size_t N, typename U, typename V>
 inline T uintx_cast(const uintx<N, U, V>& obj) {
-    return detail::partial_cast<T>()(obj.digits, uintx<N, U, V>::base);
+    return detail::partial_cast<T, V>()(obj.digits.data(), obj.digits.size());
+}
+
+/**
+ * @brief Counts the number of set bits.
+ * @details Counts the number of bits set to 1 in a uintx.
+ *
+ * @param value The value to count the bits of.
+ * @return The number of set bits.
+ */
+template<size_t N, typename U, typename V>
+inline size_t popcount(const uintx<N, U, V>& value) noexcept {
+    size_t result = 0;
+    for(size_t i = 0; i < value.digits.size(); ++i) {
+        result += detail::popcount(value.digits[i]);
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the number of bits needed to represent a value.
+ * @details Returns the number of bits needed to represent a value,
+ * i.e. one more than the index of the highest set bit, or 0 if the
+ * value is 0.
+ *
+ * @param value The value to measure.
+ * @return The bit length of the value.
+ */
+template<size_t N, typename U, typename V>
+inline size_t bit_length(const uintx<N, U, V>& value) noexcept {
+    return detail::bit_length(value.digits.data(), value.digits.size());
+}
+
+/**
+ * @brief Counts the trailing zero bits.
+ * @details Counts the consecutive zero bits starting from the least
+ * significant bit, which is the exponent of the largest power of two
+ * dividing the value. If the value is 0, `N` is returned, which is
+ * `size_t(-1)` for unbounded precision.
+ *
+ * @param value The value to count the bits of.
+ * @return The number of trailing zero bits.
+ */
+template<size_t N, typename U, typename V>
+inline size_t countr_zero(const uintx<N, U, V>& value) noexcept {
+    for(size_t i = 0; i < value.digits.size(); ++i) {
+        if(value.digits[i] != 0) {
+            return i * detail::limb_bits<U>() + detail::count_trailing_zeros(value.digits[i]);
+        }
+    }
+    return N;
+}
+
+/**
+ * @brief Checks whether a bit is set.
+ * @details Checks whether the bit with the given index, counting from
+ * the least significant bit, is set.
+ *
+ * @param value The value to check.
+ * @param bit The index of the bit.
+ * @return `true` if the bit is set, `false` otherwise.
+ */
+template<size_t N, typename U, typename V>
+inline bool test_bit(const uintx<N, U, V>& value, size_t bit) noexcept {
+    const size_t index = bit / detail::limb_bits<U>();
+    return index < value.digits.size() && ((value.digits[index] >> (bit % detail::limb_bits<U>())) & 1) != 0;
+}
+
+/**
+ * @brief Writes a uintx to a character buffer.
+ * @details Writes the digits of `value` in the given base to the range
+ * `[first, last)` without a terminating null character. Digits past 9
+ * are the lowercase letters `a` to `z`. The buffer is written to directly
+ * when it is large enough for the widest value of the same bit length,
+ * larger bases use a subquadratic divide and conquer conversion while
+ * bases that are a power of two are converted in linear time.
+ *
+ * @param first The beginning of the buffer.
+ * @param last The end of the buffer.
+ * @param value The value to write.
+ * @param base The base to write in, from 2 to 36.
+ * @return The end of the written characters and an error code.
+ */
+template<size_t N, typename U, typename V>
+inline to_chars_result to_chars(char* first, char* last, const uintx<N, U, V>& value, int base) {
+    if(base < 2 || base > 36) {
+        return { last, std::errc::invalid_argument };
+    }
+
+    const size_t n = value.digits.size();
+    const size_t available = static_cast<size_t>(last - first);
+    if(n == 0) {
+        if(available == 0) {
+            return { last, std::errc::value_too_large };
+        }
+        *first = '0';
+        return { first + 1, std::errc() };
+    }
+
+    detail::radix<U> r(static_cast<unsigned>(base));
+    const size_t bound = r.digits(detail::bit_length(value.digits.data(), n));
+    if(available < bound) {
+        auto str = detail::to_radix_string<V>(value.digits.data(), n, static_cast<unsigned>(base));
+        if(available < str.size()) {
+            return { last, std::errc::value_too_large };
+        }
+        return { std::copy(str.begin(), str.end(), first), std::errc() };
+    }
+
+    detail::to_radix<V>(first, bound, value.digits.data(), n, r);
+    char* start = first;
+    while(*start == '0') {
+        ++start;
+    }
+    return { std::copy(start, first + bound, first), std::errc() };
+}
+
+/**
+ * @brief Parses a uintx from a character buffer.
+ * @details Parses the longest sequence of digits of the given base at the
+ * beginning of `[first, last)` into `value`. Digits past 9 are the letters
+ * `a` to `z` in either case. No sign, prefix or whitespace is accepted.
+ * `value` is only modified on success. The conversion uses the same
+ * divide and conquer scheme as `to_chars`.
+ *
+ * @param first The beginning of the characters to parse.
+ * @param last The end of the characters to parse.
+ * @param value The uintx to store the result in.
+ * @param base The base to parse in, from 2 to 36.
+ * @return The end of the parsed characters and an error code.
+ */
+template<size_t N, typename U, typename V>
+inline from_chars_result from_chars(const char* first, const char* last, uintx<N, U, V>& value, int base) {
+    if(base < 2 || base > 36) {
+        return { first, std::errc::invalid_argument };
+    }
+
+    const char* end = first;
+    while(end != last && detail::radix_value(*end) < static_cast<unsigned>(base)) {
+        ++end;
+    }
+
+    if(end == first) {
+        return { first, std::errc::invalid_argument };
+    }
+
+    detail::radix<U> r(static_cast<unsigned>(base));
+    std::vector<U> limbs;
+    detail::from_radix<V>(limbs, first, static_cast<size_t>(end - first), r);
+    if(N != size_t(-1) && detail::bit_length(limbs.data(), limbs.size()) > N) {
+        return { end, std::errc::result_out_of_range };
+    }
+
+    value.assign(limbs);
+    return { end, std::errc() };
 }
 
+/**
+ * @brief Computes the quotient and remainder of a division at once.
+ * @details Computes the quotient and remainder of a division at once.
+ * This does the work of `operator/` and `operator%` in a single pass.
+ *
+ * @throws std::logic_error Thrown when division by zero occurs.
+ * @param numerator The number to divide.
+ * @param denominator The number to divide by.
+ * @return A pair of the quotient and the remainder, in that order.
+ */
+template<size_t N, typename U, typename V>
+inline std::pair<uintx<N, U, V>, uintx<N, U, V>> divmod(const uintx<N, U, V>& numerator, const uintx<N, U, V>& denominator) {
+    std::pair<uintx<N, U, V>, uintx<N, U, V>> result;
+    uintx<N, U, V>::divide(numerator, denominator, &result.first, &result.second);
+    return result;
+}
+
+/**
+ * @brief Adds a product to a uintx in place.
+ * @details Computes `result += lhs * rhs` without creating a temporary
+ * for `result`. When either factor fits in a single limb the product is
+ * accumulated directly into `result`, which makes evaluating polynomials
+ * with small coefficients by Horner's rule allocation free.
+ *
+ * @param result The uintx to add the product to.
+ * @param lhs The first factor.
+ * @param rhs The second factor.
+ * @return A reference to `result`.
+ */
+template<size_t N, typename U, typename V>
+inline uintx<N, U, V>& add_mul(uintx<N, U, V>& result, const uintx<N, U, V>& lhs, const uintx<N, U, V>& rhs) {
+    uintx<N, U, V>::fused(result, lhs, rhs, false);
+    return result;
+}
+
+/**
+ * @brief Subtracts a product from a uintx in place.
+ * @details Computes `result -= lhs * rhs` the same way `add_mul` does. If
+ * the product is larger than `result`, the behaviour is undefined unless
+ * the precision is bounded, in which case the result wraps around.
+ *
+ * @param result The uintx to subtract the product from.
+ * @param lhs The first factor.
+ * @param rhs The second factor.
+ * @return A reference to `result`.
+ */
+template<size_t N, typename U, typename V>
+inline uintx<N, U, V>& sub_mul(uintx<N, U, V>& result, const uintx<N, U, V>& lhs, const uintx<N, U, V>& rhs) {
+    uintx<N, U, V>::fused(result, lhs, rhs, true);
+    return result;
+}
+
+/**
+ * @brief Computes a fused multiply-add.
+ * @details Computes `lhs * rhs + addend`, building the product in the
+ * buffer that is returned so no other temporaries are created.
+ *
+ * @param lhs The first factor.
+ * @param rhs The second factor.
+ * @param addend The value added to the product.
+ * @return The result of `lhs * rhs + addend`.
+ */
+template<size_t N, typename U, typename V>
+inline uintx<N, U, V> fma(const uintx<N, U, V>& lhs, const uintx<N, U, V>& rhs, const uintx<N, U, V>& addend) {
+    uintx<N, U, V> result;
+    uintx<N, U, V>::multiply(result.digits, lhs, rhs);
+    result.check_bits();
+    result += addend;
+    return result;
+}
+
+/**
+ * @brief Calculates the greatest common divisor of two uintx.
+ * @details Calculates the greatest common divisor with Lehmer's algorithm.
+ * Most steps of Euclid's algorithm are carried out on the leading bits in
+ * machine words and applied to the full numbers in a single linear pass,
+ * so the full division Euclid's algorithm needs at every step is only
+ * done when a quotient does not fit in a word.
+ *
+ * @param lhs Left hand side.
+ * @param rhs Right hand side.
+ * @return The greatest common divisor, or 0 if both are 0.
+ */
+template<size_t N, typename U, typename V>
+inline uintx<N, U, V> gcd(const uintx<N, U, V>& lhs, const uintx<N, U, V>& rhs) {
+    std::vector<U> u(lhs.digits.data(), lhs.digits.data() + lhs.digits.size());
+    std::vector<U> v(rhs.digits.data(), rhs.digits.data() + rhs.digits.size());
+    detail::gcd_lehmer<V>(u, v);
+    uintx<N, U, V> result;
+    result.assign(u);
+    return result;
+}
+
+/**
+ * @ingroup math
+ * @brief Modular arithmetic context for uintx.
+ * @details Modular arithmetic context for uintx. The constructor
+ * precomputes the constant for Barrett reduction, which `reduce`,
+ * `mul` and `sqr` use instead of a division. For odd moduli it also
+ * precomputes the constants for Montgomery multiplication, which `pow`
+ * uses for all of its multiplications. Even moduli use Barrett reduction
+ * in `pow` instead. Exponentiation uses a sliding window whose size grows
+ * with the exponent, so most of the work is squaring.
+ *
+ * This is what `mod_pow` uses for uintx, but constructing a context once
+ * and reusing it saves the precomputation when the modulus is fixed.
+ *
+ * @throws std::logic_error Thrown by the constructor if the modulus is 0.
+ */
+template<size_t Bits, typename Digit, typename Digits>
+class modular<uintx<Bits, Digit, Digits>> {
+private:
+    using value_type = uintx<Bits, Digit, Digits>;
+    using limbs = std::vector<Digit>;
+
+    value_type m;
+    limbs mu;        // floor(B^2n / m) for Barrett reduction
+    Digit inverse;   // -m^-1 mod B, or 0 if m is even
+    limbs r2;        // B^2n mod m, converts to the Montgomery form
+
+    size_t size() const noexcept {
+        return m.digits.size();
+    }
+
+    // value reduced and padded to n limbs
+    limbs residue(const value_type& value) const {
+        limbs result(size());
+        if(value < m) {
+            std::copy(value.digits.data(), value.digits.data() + value.digits.size(), result.begin());
+        }
+        else {
+            const value_type rest = value % m;
+            std::copy(rest.digits.data(), rest.digits.data() + rest.digits.size(), result.begin());
+        }
+        return result;
+    }
+
+    value_type make_value(limbs& value) const {
+        value.resize(detail::trim(value.data(), value.size()));
+        value_type result;
+        result.assign(value);
+        return result;
+    }
+
+    // out = a * b mod m for residues of n limbs, out must not alias either
+    void barrett_mul(Digit* out, const Digit* a, const Digit* b, limbs& product) const {
+        const size_t n = size();
+        detail::mul<Digits>(product.data(), a, n, b, n);
+        detail::barrett_reduce<Digits>(out, product.data(), 2 * n, m.digits.data(), n, mu);
+    }
+
+    // out = a * b / B^n mod m for Montgomery residues of n limbs
+    void montgomery_mul(Digit* out, const Digit* a, const Digit* b, limbs& product) const {
+        const size_t n = size();
+        detail::mul<Digits>(product.data(), a, n, b, n);
+        product[2 * n] = 0;
+        detail::redc<Digits>(out, product.data(), m.digits.data(), n, inverse);
+    }
+
+    // base^exponent where multiply(out, a, b) multiplies two residues and
+    // one is the residue of 1.
+    template<typename Multiply>
+    limbs window_pow(const limbs& base, limbs one, const value_type& exponent, Multiply multiply) const {
+        const size_t n = size();
+        size_t bits = bit_length(exponent);
+        const size_t window = detail::window_size(bits);
+
+        // the odd powers base, base^3, ..., base^(2^window - 1)
+        std::vector<limbs> table(size_t(1) << (window - 1), limbs(n));
+        limbs square(n);
+        table[0] = base;
+        multiply(square.data(), base.data(), base.data());
+        for(size_t i = 1; i < table.size(); ++i) {
+            multiply(table[i].data(), table[i - 1].data(), square.data());
+        }
+
+        limbs result = std::move(one);
+        limbs temp(n);
+        bool started = false;
+        while(bits > 0) {
+            if(!test_bit(exponent, bits - 1)) {
+                if(started) {
+                    multiply(temp.data(), result.data(), result.data());
+                    result.swap(temp);
+                }
+                --bits;
+                continue;
+            }
+
+            // the longest window of at most window bits that ends in a one
+            size_t length = window < bits ? window : bits;
+            while(!test_bit(exponent, bits - length)) {
+                --length;
+            }
+
+            size_t value = 0;
+            for(size_t i = 0; i < length; ++i) {
+                value = (value << 1) | test_bit(exponent, bits - 1 - i);
+            }
+
+            if(started) {
+                for(size_t i = 0; i < length; ++i) {
+                    multiply(temp.data(), result.data(), result.data());
+                    result.swap(temp);
+                }
+                multiply(temp.data(), result.data(), table[value >> 1].data());
+                result.swap(temp);
+            }
+            else {
+                result = table[value >> 1];
+                started = true;
+            }
+            bits -= length;
+        }
+        return result;
+    }
+public:
+    /**
+     * @brief Constructs a context for a modulus.
+     * @details Constructs a context for a modulus and precomputes
+     * the constants used for reduction.
+     *
+     * @throws std::logic_error Thrown when the modulus is 0.
+     * @param modulus The modulus to reduce by.
+     */
+    explicit modular(value_type modulus): m(std::move(modulus)), inverse(0) {
+        if(!m) {
+            throw std::logic_error("Division by zero");
+        }
+
+        r2.resize(size());
+        mu = detail::barrett_constant<Digits>(r2.data(), m.digits.data(), size());
+        if(m.digits[0] & 1) {
+            inverse = detail::montgomery_inverse<Digits>(m.digits[0]);
+        }
+    }
+
+    /**
+     * @brief Returns the modulus of the context.
+     */
+    const value_type& modulus() const noexcept {
+        return m;
+    }
+
+    /**
+     * @brief Reduces a number by the modulus.
+     */
+    value_type reduce(const value_type& value) const {
+        if(value.digits.size() > 2 * size()) {
+            return value % m;
+        }
+
+        limbs result(size());
+        detail::barrett_reduce<Digits>(result.data(), value.digits.data(), value.digits.size(), m.digits.data(), size(), mu);
+        return make_value(result);
+    }
+
+    /**
+     * @brief Computes `(lhs * rhs) % modulus`.
+     */
+    value_type mul(const value_type& lhs, const value_type& rhs) const {
+        const auto a = residue(lhs);
+        const auto b = residue(rhs);
+        limbs product(2 * size());
+        limbs result(size());
+        barrett_mul(result.data(), a.data(), b.data(), product);
+        return make_value(result);
+    }
+
+    /**
+     * @brief Computes `(value * value) % modulus`.
+     */
+    value_type sqr(const value_type& value) const {
+        const auto a = residue(value);
+        limbs product(2 * size());
+        limbs result(size());
+        barrett_mul(result.data(), a.data(), a.data(), product);
+        return make_value(result);
+    }
+
+    /**
+     * @brief Calculates the modular exponentiation.
+     * @details Calculates `(base ** exponent) % modulus` where `**`
+     * denotes exponentiation, using sliding window exponentiation.
+     *
+     * @param base The base number of the formula.
+     * @param exponent The exponent number of the formula.
+     * @return `(base ** exponent) % modulus`.
+     */
+    value_type pow(const value_type& base, const value_type& exponent) const {
+        const size_t n = size();
+        if(n == 1 && m.digits[0] == 1) {
+            return value_type();
+        }
+
+        if(!exponent) {
+            return value_type(1);
+        }
+
+        limbs product(2 * n + 1);
+        limbs result(n);
+        if(inverse) {
+            // work on x B^n mod m so every product only needs one redc
+            auto multiply = [this, &product](Digit* out, const Digit* a, const Digit* b) {
+                montgomery_mul(out, a, b, product);
+            };
+
+            limbs x = residue(base);
+            limbs one(n);
+            one[0] = 1;
+            multiply(x.data(), x.data(), r2.data());
+            multiply(one.data(), one.data(), r2.data());
+            auto power = window_pow(x, std::move(one), exponent, multiply);
+            std::copy(power.begin(), power.end(), product.begin());
+            std::fill(product.begin() + n, product.end(), Digit(0));
+            detail::redc<Digits>(result.data(), product.data(), m.digits.data(), n, inverse);
+        }
+        else {
+            auto multiply = [this, &product](Digit* out, const Digit* a, const Digit* b) {
+                barrett_mul(out, a, b, product);
+            };
+
+            limbs one(n);
+            one[0] = 1;
+            result = window_pow(residue(base), std::move(one), exponent, multiply);
+        }
+        return make_value(result);
+    }
+};
+
 namespace literals {
 template<char... Numbers>
 inline uintx<> operator"" _x() noexcept {
@@ -0,0 +1,287 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef GEARS_MATH_UINTX_DIVIDE_HPP
+#define GEARS_MATH_UINTX_DIVIDE_HPP
+
+#include <gears/math/uintx/limbs.hpp>
+#include <gears/math/uintx/multiply.hpp>
+#include <vector>
+
+// Divisor and quotient size, in limbs, from which division multiplies by a
+// Newton reciprocal instead of running Knuth's algorithm D.
+#ifndef GEARS_UINTX_NEWTON_THRESHOLD
+#define GEARS_UINTX_NEWTON_THRESHOLD 2000
+#endif // GEARS_UINTX_NEWTON_THRESHOLD
+
+namespace gears {
+namespace math {
+namespace detail {
+// Knuth's algorithm D. q = a / b and r = a % b, requires an >= bn >= 2 and
+// b[bn - 1] != 0. q holds an - bn + 1 limbs, r holds bn limbs and scratch
+// holds an + bn + 1 limbs.
+template<typename Digits, typename Digit>
+inline void divrem_knuth(Digit* q, Digit* r, const Digit* a, size_t an, const Digit* b, size_t bn, Digit* scratch) {
+    const unsigned shift = count_leading_zeros(b[bn - 1]);
+    const size_t bits = limb_bits<Digit>();
+    const Digits base = Digits(1) << bits;
+    Digit* u = scratch;
+    Digit* v = scratch + an + 1;
+
+    // normalise so the top bit of the divisor is set
+    if(shift) {
+        lshift(v, b, bn, shift);
+        u[an] = lshift(u, a, an, shift);
+    }
+    else {
+        for(size_t i = 0; i < bn; ++i) {
+            v[i] = b[i];
+        }
+
+        for(size_t i = 0; i < an; ++i) {
+            u[i] = a[i];
+        }
+        u[an] = 0;
+    }
+
+    const Digit top = v[bn - 1];
+    const Digit next = v[bn - 2];
+    for(size_t j = an - bn + 1; j > 0;) {
+        --j;
+        const Digits numerator = (Digits(u[j + bn]) << bits) | u[j + bn - 1];
+        Digits estimate = numerator / top;
+        Digits rest = numerator % top;
+
+        while(estimate >= base || estimate * next > ((rest << bits) | u[j + bn - 2])) {
+            --estimate;
+            rest += top;
+            if(rest >= base) {
+                break;
+            }
+        }
+
+        const Digit borrow = submul_1<Digits>(u + j, v, bn, static_cast<Digit>(estimate));
+        const Digit high = u[j + bn];
+        u[j + bn] = static_cast<Digit>(high - borrow);
+
+        // the estimate was one too large, add the divisor back
+        if(high < borrow) {
+            --estimate;
+            u[j + bn] = static_cast<Digit>(u[j + bn] + add<Digits>(u + j, u + j, bn, v, bn));
+        }
+        q[j] = static_cast<Digit>(estimate);
+    }
+
+    if(shift) {
+        rshift(r, u, bn, shift);
+    }
+    else {
+        for(size_t i = 0; i < bn; ++i) {
+            r[i] = u[i];
+        }
+    }
+}
+
+template<typename Digits, typename Digit>
+inline std::vector<Digit> multiply(const Digit* a, size_t an, const Digit* b, size_t bn) {
+    an = trim(a, an);
+    bn = trim(b, bn);
+    if(an == 0 || bn == 0) {
+        return {};
+    }
+
+    std::vector<Digit> result(an + bn);
+    if(an >= bn) {
+        mul<Digits>(result.data(), a, an, b, bn);
+    }
+    else {
+        mul<Digits>(result.data(), b, bn, a, an);
+    }
+    result.resize(trim(result.data(), result.size()));
+    return result;
+}
+
+// a -= b in place where a >= b
+template<typename Digits, typename Digit>
+inline void subtract(std::vector<Digit>& a, const Digit* b, size_t bn) {
+    sub<Digits>(a.data(), a.data(), a.size(), b, trim(b, bn));
+    a.resize(trim(a.data(), a.size()));
+}
+
+// a += b in place
+template<typename Digits, typename Digit>
+inline void increase(std::vector<Digit>& a, const Digit* b, size_t bn) {
+    bn = trim(b, bn);
+    if(a.size() < bn) {
+        a.resize(bn);
+    }
+
+    Digit carry = add<Digits>(a.data(), a.data(), a.size(), b, bn);
+    if(carry) {
+        a.push_back(carry);
+    }
+}
+
+// Computes floor(B^2n / d) where d has n limbs with its top bit set and B is
+// the limb radix. Each step doubles the precision of the reciprocal of the
+// top half of d with one Newton iteration, x + x(B^2n - dx) / B^2n, and
+// then fixes the last few units so the result is exact.
+template<typename Digits, typename Digit>
+inline std::vector<Digit> reciprocal(const Digit* d, size_t n) {
+    std::vector<Digit> power(2 * n + 1);
+    power.back() = 1;
+
+    if(n < GEARS_UINTX_NEWTON_THRESHOLD || n < 4) {
+        std::vector<Digit> q(n + 2);
+        std::vector<Digit> r(n);
+        std::vector<Digit> scratch(power.size() + n + 1);
+        divrem_knuth<Digits>(q.data(), r.data(), power.data(), power.size(), d, n, scratch.data());
+        q.resize(trim(q.data(), q.size()));
+        return q;
+    }
+
+    const size_t h = (n + 1) / 2 + 1;
+    auto x = reciprocal<Digits>(d + (n - h), h);
+    x.insert(x.begin(), n - h, Digit(0));
+
+    auto dx = multiply<Digits>(d, n, x.data(), x.size());
+    const bool under = compare(dx.data(), dx.size(), power.data(), power.size()) <= 0;
+    std::vector<Digit> error = under ? power : dx;
+    subtract<Digits>(error, under ? dx.data() : power.data(), under ? dx.size() : power.size());
+
+    auto step = multiply<Digits>(x.data(), x.size(), error.data(), error.size());
+    if(step.size() > 2 * n) {
+        if(under) {
+            increase<Digits>(x, step.data() + 2 * n, step.size() - 2 * n);
+        }
+        else {
+            subtract<Digits>(x, step.data() + 2 * n, step.size() - 2 * n);
+        }
+    }
+
+    // 0 <= B^2n - dx < d has to hold for x to be the floor
+    dx = multiply<Digits>(d, n, x.data(), x.size());
+    while(compare(dx.data(), dx.size(), power.data(), power.size()) > 0) {
+        sub_1<Digits>(x.data(), x.size(), Digit(1));
+        subtract<Digits>(dx, d, n);
+    }
+
+    subtract<Digits>(power, dx.data(), dx.size());
+    while(compare(power.data(), power.size(), d, n) >= 0) {
+        if(add_1<Digits>(x.data(), x.size(), Digit(1))) {
+            x.push_back(1);
+        }
+        subtract<Digits>(power, d, n);
+    }
+
+    x.resize(trim(x.data(), x.size()));
+    return x;
+}
+
+// Division through a Newton reciprocal. Same contract as divrem_knuth. The
+// dividend is consumed in blocks of bn limbs, every block costs two
+// multiplications of bn limbs and a couple of corrections.
+template<typename Digits, typename Digit>
+inline void divrem_newton(Digit* q, Digit* r, const Digit* a, size_t an, const Digit* b, size_t bn) {
+    const unsigned shift = count_leading_zeros(b[bn - 1]);
+    const size_t n = bn;
+    std::vector<Digit> d(b, b + n);
+    std::vector<Digit> u(a, a + an);
+    u.push_back(0);
+
+    if(shift) {
+        lshift(d.data(), d.data(), n, shift);
+        u[an] = lshift(u.data(), u.data(), an, shift);
+    }
+
+    const auto v = reciprocal<Digits>(d.data(), n);
+    const size_t blocks = (u.size() + n - 1) / n;
+    const size_t quotient_size = an - bn + 1;
+    u.resize(blocks * n);
+
+    for(size_t i = 0; i < quotient_size; ++i) {
+        q[i] = 0;
+    }
+
+    // current holds remainder * B^n + block
+    std::vector<Digit> remainder;
+    std::vector<Digit> current;
+    for(size_t i = blocks; i > 0;) {
+        --i;
+        current.assign(u.begin() + i * n, u.begin() + (i + 1) * n);
+        current.insert(current.end(), remainder.begin(), remainder.end());
+        current.resize(trim(current.data(), current.size()));
+
+        auto estimate = multiply<Digits>(remainder.data(), remainder.size(), v.data(), v.size());
+        if(estimate.size() > n) {
+            estimate.erase(estimate.begin(), estimate.begin() + n);
+        }
+        else {
+            estimate.clear();
+        }
+
+        auto product = multiply<Digits>(estimate.data(), estimate.size(), d.data(), n);
+        subtract<Digits>(current, product.data(), product.size());
+
+        while(compare(current.data(), current.size(), d.data(), n) >= 0) {
+            subtract<Digits>(current, d.data(), n);
+            if(add_1<Digits>(estimate.data(), estimate.size(), Digit(1))) {
+                estimate.push_back(1);
+            }
+        }
+
+        for(size_t j = 0; j < estimate.size() && i * n + j < quotient_size; ++j) {
+            q[i * n + j] = estimate[j];
+        }
+        remainder.swap(current);
+    }
+
+    remainder.resize(n);
+    if(shift) {
+        rshift(r, remainder.data(), n, shift);
+    }
+    else {
+        for(size_t i = 0; i < n; ++i) {
+            r[i] = remainder[i];
+        }
+    }
+}
+
+// q = a / b and r = a % b, requires an >= bn > 0 and b[bn - 1] != 0.
+// q holds an - bn + 1 limbs, r holds bn limbs and scratch holds
+// an + bn + 1 limbs.
+template<typename Digits, typename Digit>
+inline void divrem(Digit* q, Digit* r, const Digit* a, size_t an, const Digit* b, size_t bn, Digit* scratch) {
+    if(bn == 1) {
+        r[0] = divrem_1<Digits>(q, a, an, b[0]);
+    }
+    else if(bn < GEARS_UINTX_NEWTON_THRESHOLD || an - bn < GEARS_UINTX_NEWTON_THRESHOLD) {
+        divrem_knuth<Digits>(q, r, a, an, b, bn, scratch);
+    }
+    else {
+        divrem_newton<Digits>(q, r, a, an, b, bn);
+    }
+}
+} // detail
+} // math
+} // gears
+
+#endif // GEARS_MATH_UINTX_DIVIDE_HPP
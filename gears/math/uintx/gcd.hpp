@@ -0,0 +1,147 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef GEARS_MATH_UINTX_GCD_HPP
+#define GEARS_MATH_UINTX_GCD_HPP
+
+#include <gears/math/uintx/limbs.hpp>
+#include <gears/math/uintx/divide.hpp>
+#include <vector>
+
+namespace gears {
+namespace math {
+namespace detail {
+// bits [low, low + count) of a as a word, count <= 62
+template<typename Digit>
+inline long long extract_bits(const std::vector<Digit>& a, size_t low, size_t count) noexcept {
+    const size_t bits = limb_bits<Digit>();
+    long long result = 0;
+    for(size_t i = count; i > 0;) {
+        --i;
+        const size_t index = (low + i) / bits;
+        const bool set = index < a.size() && ((a[index] >> ((low + i) % bits)) & 1) != 0;
+        result = (result << 1) | (set ? 1 : 0);
+    }
+    return result;
+}
+
+// out = a u + b v where a and b do not have the same sign, the result is
+// not negative and u >= v. |a| and |b| fit in a single limb.
+template<typename Digits, typename Digit>
+inline void combine(std::vector<Digit>& out, const std::vector<Digit>& u, const std::vector<Digit>& v, long long a, long long b) {
+    const bool first = b <= 0;
+    const std::vector<Digit>& x = first ? u : v;
+    const std::vector<Digit>& y = first ? v : u;
+    const Digit positive = static_cast<Digit>(first ? a : b);
+    const Digit negative = static_cast<Digit>(first ? -b : -a);
+
+    out.assign(u.size() + 1, Digit(0));
+    out[x.size()] = mul_1<Digits>(out.data(), x.data(), x.size(), positive);
+    const Digit borrow = submul_1<Digits>(out.data(), y.data(), y.size(), negative);
+    sub_1<Digits>(out.data() + y.size(), out.size() - y.size(), borrow);
+    out.resize(trim(out.data(), out.size()));
+}
+
+// Lehmer's gcd, Knuth's algorithm L. The leading bits of u and v are run
+// through Euclid's algorithm in machine words for as long as the quotients
+// provably match the ones of the full numbers. The cofactors of those steps
+// are then applied to u and v in a single linear pass, so most steps cost
+// no multi-precision division at all. Once the values fit in a word, the
+// binary gcd finishes the job. u and v must be trimmed and the gcd is left
+// in u.
+template<typename Digits, typename Digit>
+inline void gcd_lehmer(std::vector<Digit>& u, std::vector<Digit>& v) {
+    const size_t precision = limb_bits<Digit>() - 1 < 61 ? limb_bits<Digit>() - 1 : 61;
+    std::vector<Digit> first;
+    std::vector<Digit> second;
+    std::vector<Digit> scratch;
+
+    if(compare(u.data(), u.size(), v.data(), v.size()) < 0) {
+        u.swap(v);
+    }
+
+    while(!v.empty()) {
+        const size_t bits = bit_length(u.data(), u.size());
+        if(bits <= 64) {
+            unsigned long long x = 0;
+            unsigned long long y = 0;
+            for(size_t i = 0; i < u.size(); ++i) {
+                x |= static_cast<unsigned long long>(u[i]) << (i * limb_bits<Digit>());
+            }
+
+            for(size_t i = 0; i < v.size(); ++i) {
+                y |= static_cast<unsigned long long>(v[i]) << (i * limb_bits<Digit>());
+            }
+
+            u.clear();
+            for(x = binary_gcd(x, y); x != 0; x = shift_right(x, limb_bits<Digit>())) {
+                u.push_back(static_cast<Digit>(x));
+            }
+            return;
+        }
+
+        const size_t low = bits - precision;
+        long long uh = extract_bits(u, low, precision);
+        long long vh = extract_bits(v, low, precision);
+        long long a = 1, b = 0, c = 0, d = 1;
+
+        // stopping early is always safe, it only costs a division step
+        while(vh + c > 0 && vh + d > 0 && uh + a >= 0 && uh + b >= 0) {
+            const long long q = (uh + a) / (vh + c);
+            if(q != (uh + b) / (vh + d)) {
+                break;
+            }
+
+            long long t = a - q * c;
+            a = c;
+            c = t;
+            t = b - q * d;
+            b = d;
+            d = t;
+            t = uh - q * vh;
+            uh = vh;
+            vh = t;
+        }
+
+        if(b == 0) {
+            // the quotient is too large for a word, do one full step
+            first.resize(u.size() - v.size() + 1);
+            second.resize(v.size());
+            scratch.resize(u.size() + v.size() + 1);
+            divrem<Digits>(first.data(), second.data(), u.data(), u.size(), v.data(), v.size(), scratch.data());
+            second.resize(trim(second.data(), second.size()));
+            u.swap(v);
+            v.swap(second);
+        }
+        else {
+            combine<Digits>(first, u, v, a, b);
+            combine<Digits>(second, u, v, c, d);
+            u.swap(first);
+            v.swap(second);
+        }
+    }
+}
+} // detail
+} // math
+} // gears
+
+#endif // GEARS_MATH_UINTX_GCD_HPP
@@ -0,0 +1,348 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef GEARS_MATH_UINTX_LIMBS_HPP
+#define GEARS_MATH_UINTX_LIMBS_HPP
+
+#include <cstddef>
+#include <climits>
+
+namespace gears {
+namespace math {
+namespace detail {
+// Low level kernels that operate on little endian arrays of binary limbs.
+// A Digit is a single limb and Digits is an unsigned type at least twice
+// as wide, used to hold the full result of a limb sum or product so the
+// carry can be taken from its high half.
+
+template<typename Digit>
+constexpr size_t limb_bits() noexcept {
+    return sizeof(Digit) * CHAR_BIT;
+}
+
+template<typename T>
+constexpr T shift_right(T value, size_t shift) noexcept {
+    return shift >= sizeof(T) * CHAR_BIT ? T(0) : static_cast<T>(value >> shift);
+}
+
+template<typename T>
+constexpr T shift_left(T value, size_t shift) noexcept {
+    return shift >= sizeof(T) * CHAR_BIT ? T(0) : static_cast<T>(value << shift);
+}
+
+// The bit queries below use the GCC and Clang builtins for limbs of up to
+// 64 bits and fall back to portable loops otherwise.
+template<typename Digit>
+inline unsigned count_leading_zeros(Digit value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    if(value != 0 && sizeof(Digit) <= sizeof(unsigned)) {
+        return static_cast<unsigned>(__builtin_clz(static_cast<unsigned>(value))) - (limb_bits<unsigned>() - limb_bits<Digit>());
+    }
+
+    if(value != 0 && sizeof(Digit) <= sizeof(unsigned long long)) {
+        return static_cast<unsigned>(__builtin_clzll(static_cast<unsigned long long>(value))) - (limb_bits<unsigned long long>() - limb_bits<Digit>());
+    }
+#endif
+    unsigned result = 0;
+    for(Digit mask = static_cast<Digit>(Digit(1) << (limb_bits<Digit>() - 1)); mask && !(value & mask); mask >>= 1) {
+        ++result;
+    }
+    return result;
+}
+
+template<typename Digit>
+inline unsigned count_trailing_zeros(Digit value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    if(value != 0 && sizeof(Digit) <= sizeof(unsigned long long)) {
+        return static_cast<unsigned>(__builtin_ctzll(static_cast<unsigned long long>(value)));
+    }
+#endif
+    unsigned result = 0;
+    for(Digit mask = 1; mask && !(value & mask); mask <<= 1) {
+        ++result;
+    }
+    return result;
+}
+
+template<typename Digit>
+inline unsigned popcount(Digit value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    if(sizeof(Digit) <= sizeof(unsigned long long)) {
+        return static_cast<unsigned>(__builtin_popcountll(static_cast<unsigned long long>(value)));
+    }
+#endif
+    unsigned result = 0;
+    for(; value; value &= static_cast<Digit>(value - 1)) {
+        ++result;
+    }
+    return result;
+}
+
+// Stein's binary gcd of two unsigned words. Every iteration removes the
+// factors of two from y and then replaces the larger value by the
+// difference, so there are no divisions.
+template<typename T>
+inline T binary_gcd(T x, T y) noexcept {
+    if(x == 0 || y == 0) {
+        return static_cast<T>(x | y);
+    }
+
+    const unsigned shift = count_trailing_zeros(static_cast<T>(x | y));
+    x = static_cast<T>(x >> count_trailing_zeros(x));
+    do {
+        y = static_cast<T>(y >> count_trailing_zeros(y));
+        if(x > y) {
+            const T temp = x;
+            x = y;
+            y = temp;
+        }
+        y = static_cast<T>(y - x);
+    }
+    while(y != 0);
+    return static_cast<T>(x << shift);
+}
+
+// number of significant bits in a, requires a[n - 1] != 0 when n > 0
+template<typename Digit>
+inline size_t bit_length(const Digit* a, size_t n) noexcept {
+    return n == 0 ? 0 : n * limb_bits<Digit>() - count_leading_zeros(a[n - 1]);
+}
+
+template<typename Digit>
+inline size_t trim(const Digit* a, size_t n) noexcept {
+    while(n > 0 && a[n - 1] == 0) {
+        --n;
+    }
+    return n;
+}
+
+template<typename Digit>
+inline int compare(const Digit* a, size_t an, const Digit* b, size_t bn) noexcept {
+    if(an != bn) {
+        return an < bn ? -1 : 1;
+    }
+
+    while(an > 0) {
+        --an;
+        if(a[an] != b[an]) {
+            return a[an] < b[an] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// out = a + b, requires an >= bn. out may alias a or b.
+template<typename Digits, typename Digit>
+inline Digit add(Digit* out, const Digit* a, size_t an, const Digit* b, size_t bn) noexcept {
+    Digit carry = 0;
+    size_t i = 0;
+    for(; i < bn; ++i) {
+        Digits sum = Digits(a[i]) + b[i] + carry;
+        out[i] = static_cast<Digit>(sum);
+        carry = static_cast<Digit>(sum >> limb_bits<Digit>());
+    }
+
+    for(; i < an; ++i) {
+        Digits sum = Digits(a[i]) + carry;
+        out[i] = static_cast<Digit>(sum);
+        carry = static_cast<Digit>(sum >> limb_bits<Digit>());
+    }
+    return carry;
+}
+
+// out = a - b, requires an >= bn. out may alias a or b.
+template<typename Digits, typename Digit>
+inline Digit sub(Digit* out, const Digit* a, size_t an, const Digit* b, size_t bn) noexcept {
+    Digit borrow = 0;
+    size_t i = 0;
+    for(; i < bn; ++i) {
+        Digits difference = Digits(a[i]) - b[i] - borrow;
+        out[i] = static_cast<Digit>(difference);
+        borrow = static_cast<Digit>(difference >> limb_bits<Digit>()) & 1;
+    }
+
+    for(; i < an; ++i) {
+        Digits difference = Digits(a[i]) - borrow;
+        out[i] = static_cast<Digit>(difference);
+        borrow = static_cast<Digit>(difference >> limb_bits<Digit>()) & 1;
+    }
+    return borrow;
+}
+
+// a += value in place, returns the carry
+template<typename Digits, typename Digit>
+inline Digit add_1(Digit* a, size_t n, Digit value) noexcept {
+    for(size_t i = 0; value && i < n; ++i) {
+        Digits sum = Digits(a[i]) + value;
+        a[i] = static_cast<Digit>(sum);
+        value = static_cast<Digit>(sum >> limb_bits<Digit>());
+    }
+    return value;
+}
+
+// a -= value in place, returns the borrow
+template<typename Digits, typename Digit>
+inline Digit sub_1(Digit* a, size_t n, Digit value) noexcept {
+    for(size_t i = 0; value && i < n; ++i) {
+        Digits difference = Digits(a[i]) - value;
+        a[i] = static_cast<Digit>(difference);
+        value = static_cast<Digit>(difference >> limb_bits<Digit>()) & 1;
+    }
+    return value;
+}
+
+// out = a * k + carry, returns the high limb. out may alias a.
+template<typename Digits, typename Digit>
+inline Digit mul_1(Digit* out, const Digit* a, size_t n, Digit k, Digit carry = 0) noexcept {
+    for(size_t i = 0; i < n; ++i) {
+        Digits product = Digits(a[i]) * k + carry;
+        out[i] = static_cast<Digit>(product);
+        carry = static_cast<Digit>(product >> limb_bits<Digit>());
+    }
+    return carry;
+}
+
+// out += a * k, returns the high limb
+template<typename Digits, typename Digit>
+inline Digit addmul_1(Digit* out, const Digit* a, size_t n, Digit k) noexcept {
+    Digit carry = 0;
+    for(size_t i = 0; i < n; ++i) {
+        Digits product = Digits(a[i]) * k + out[i] + carry;
+        out[i] = static_cast<Digit>(product);
+        carry = static_cast<Digit>(product >> limb_bits<Digit>());
+    }
+    return carry;
+}
+
+// out -= a * k, returns the high limb that still has to be subtracted
+template<typename Digits, typename Digit>
+inline Digit submul_1(Digit* out, const Digit* a, size_t n, Digit k) noexcept {
+    Digit carry = 0;
+    for(size_t i = 0; i < n; ++i) {
+        Digits product = Digits(a[i]) * k + carry;
+        Digit low = static_cast<Digit>(product);
+        carry = static_cast<Digit>(product >> limb_bits<Digit>());
+        Digit current = out[i];
+        out[i] = static_cast<Digit>(current - low);
+        carry = static_cast<Digit>(carry + (current < low));
+    }
+    return carry;
+}
+
+// out = a * b, out must hold an + bn limbs and must not alias a or b
+template<typename Digits, typename Digit>
+inline void mul_basecase(Digit* out, const Digit* a, size_t an, const Digit* b, size_t bn) noexcept {
+    out[an] = mul_1<Digits>(out, a, an, b[0]);
+    for(size_t i = 1; i < bn; ++i) {
+        out[an + i] = addmul_1<Digits>(out + i, a, an, b[i]);
+    }
+}
+
+// out = a * a, out must hold 2n limbs and must not alias a. Each cross
+// product a[i] a[j] is only computed once and then doubled.
+template<typename Digits, typename Digit>
+inline void sqr_basecase(Digit* out, const Digit* a, size_t n) noexcept {
+    for(size_t i = 0; i < 2 * n; ++i) {
+        out[i] = 0;
+    }
+
+    for(size_t i = 0; i + 1 < n; ++i) {
+        out[i + n] = addmul_1<Digits>(out + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+    }
+
+    Digit carry = 0;
+    for(size_t i = 0; i < 2 * n; ++i) {
+        const Digit high = static_cast<Digit>(out[i] >> (limb_bits<Digit>() - 1));
+        out[i] = static_cast<Digit>((out[i] << 1) | carry);
+        carry = high;
+    }
+
+    carry = 0;
+    for(size_t i = 0; i < n; ++i) {
+        const Digits square = Digits(a[i]) * a[i];
+        const Digits low = Digits(out[2 * i]) + static_cast<Digit>(square) + carry;
+        out[2 * i] = static_cast<Digit>(low);
+        const Digits high = Digits(out[2 * i + 1]) + static_cast<Digit>(square >> limb_bits<Digit>()) + static_cast<Digit>(low >> limb_bits<Digit>());
+        out[2 * i + 1] = static_cast<Digit>(high);
+        carry = static_cast<Digit>(high >> limb_bits<Digit>());
+    }
+}
+
+// out = (a * b) mod B^n where B is the limb radix. out holds n limbs and
+// must not alias a or b.
+template<typename Digits, typename Digit>
+inline void mul_low(Digit* out, size_t n, const Digit* a, size_t an, const Digit* b, size_t bn) noexcept {
+    for(size_t i = 0; i < n; ++i) {
+        out[i] = 0;
+    }
+
+    for(size_t i = 0; i < bn && i < n; ++i) {
+        const size_t size = an < n - i ? an : n - i;
+        Digit carry = addmul_1<Digits>(out + i, a, size, b[i]);
+        if(i + size < n) {
+            out[i + size] = carry;
+        }
+    }
+}
+
+// q = a / d, returns a % d. q may alias a.
+template<typename Digits, typename Digit>
+inline Digit divrem_1(Digit* q, const Digit* a, size_t n, Digit d) noexcept {
+    Digits remainder = 0;
+    while(n > 0) {
+        --n;
+        Digits current = (remainder << limb_bits<Digit>()) | a[n];
+        q[n] = static_cast<Digit>(current / d);
+        remainder = current % d;
+    }
+    return static_cast<Digit>(remainder);
+}
+
+// out = a << shift where 0 < shift < limb_bits, returns the bits shifted out.
+// out may alias a.
+template<typename Digit>
+inline Digit lshift(Digit* out, const Digit* a, size_t n, unsigned shift) noexcept {
+    const unsigned back = limb_bits<Digit>() - shift;
+    Digit high = static_cast<Digit>(a[n - 1] >> back);
+    for(size_t i = n - 1; i > 0; --i) {
+        out[i] = static_cast<Digit>((a[i] << shift) | (a[i - 1] >> back));
+    }
+    out[0] = static_cast<Digit>(a[0] << shift);
+    return high;
+}
+
+// out = a >> shift where 0 < shift < limb_bits, returns the bits shifted out
+// in the high bits of the result. out may alias a.
+template<typename Digit>
+inline Digit rshift(Digit* out, const Digit* a, size_t n, unsigned shift) noexcept {
+    const unsigned back = limb_bits<Digit>() - shift;
+    Digit low = static_cast<Digit>(a[0] << back);
+    for(size_t i = 0; i + 1 < n; ++i) {
+        out[i] = static_cast<Digit>((a[i] >> shift) | (a[i + 1] << back));
+    }
+    out[n - 1] = static_cast<Digit>(a[n - 1] >> shift);
+    return low;
+}
+} // detail
+} // math
+} // gears
+
+#endif // GEARS_MATH_UINTX_LIMBS_HPP
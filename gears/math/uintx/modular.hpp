@@ -0,0 +1,118 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#ifndef GEARS_MATH_UINTX_MODULAR_HPP
+#define GEARS_MATH_UINTX_MODULAR_HPP
+
+#include <gears/math/uintx/limbs.hpp>
+#include <gears/math/uintx/multiply.hpp>
+#include <gears/math/uintx/divide.hpp>
+#include <vector>
+
+namespace gears {
+namespace math {
+namespace detail {
+// -m0^-1 mod B for an odd limb m0. Every Newton step x(2 - m0 x) doubles
+// the number of correct low bits, and m0 is its own inverse modulo 8.
+template<typename Digits, typename Digit>
+inline Digit montgomery_inverse(Digit m0) noexcept {
+    Digit inverse = m0;
+    for(size_t bits = 3; bits < limb_bits<Digit>(); bits *= 2) {
+        const Digit product = static_cast<Digit>(Digits(m0) * inverse);
+        inverse = static_cast<Digit>(Digits(inverse) * static_cast<Digit>(Digit(2) - product));
+    }
+    return static_cast<Digit>(Digit(0) - inverse);
+}
+
+// Montgomery reduction, out = t / B^n mod m where m has n limbs and is odd,
+// t holds 2n + 1 limbs with t < m B^n and inverse = -m^-1 mod B. t is
+// clobbered and out holds n limbs.
+template<typename Digits, typename Digit>
+inline void redc(Digit* out, Digit* t, const Digit* m, size_t n, Digit inverse) noexcept {
+    for(size_t i = 0; i < n; ++i) {
+        const Digit u = static_cast<Digit>(Digits(t[i]) * inverse);
+        const Digit carry = addmul_1<Digits>(t + i, m, n, u);
+        add_1<Digits>(t + i + n, n + 1 - i, carry);
+    }
+
+    // t / B^n < 2m here
+    if(t[2 * n] || compare(t + n, n, m, n) >= 0) {
+        sub<Digits>(out, t + n, n, m, n);
+    }
+    else {
+        for(size_t i = 0; i < n; ++i) {
+            out[i] = t[n + i];
+        }
+    }
+}
+
+// floor(B^2n / m) where m has n limbs, the constant of Barrett reduction.
+// r holds n limbs and receives B^2n mod m.
+template<typename Digits, typename Digit>
+inline std::vector<Digit> barrett_constant(Digit* r, const Digit* m, size_t n) {
+    std::vector<Digit> power(2 * n + 1);
+    power.back() = 1;
+    std::vector<Digit> q(n + 2);
+    std::vector<Digit> scratch(power.size() + n + 1);
+    divrem<Digits>(q.data(), r, power.data(), power.size(), m, n, scratch.data());
+    q.resize(trim(q.data(), q.size()));
+    return q;
+}
+
+// Barrett reduction, out = x mod m where m has n limbs, x has at most 2n
+// limbs and mu = floor(B^2n / m). The quotient estimate is at most two
+// less than the real one. out holds n limbs.
+template<typename Digits, typename Digit>
+inline void barrett_reduce(Digit* out, const Digit* x, size_t xn, const Digit* m, size_t n, const std::vector<Digit>& mu) {
+    xn = trim(x, xn);
+    std::vector<Digit> r(x, x + (xn < n + 1 ? xn : n + 1));
+    r.resize(n + 1);
+
+    if(xn >= n) {
+        // q = floor(floor(x / B^(n - 1)) mu / B^(n + 1))
+        auto q = multiply<Digits>(x + n - 1, xn - n + 1, mu.data(), mu.size());
+        if(q.size() > n + 1) {
+            std::vector<Digit> qm(n + 1);
+            mul_low<Digits>(qm.data(), n + 1, q.data() + n + 1, q.size() - n - 1, m, n);
+            sub<Digits>(r.data(), r.data(), n + 1, qm.data(), n + 1);
+        }
+    }
+
+    while(compare(r.data(), trim(r.data(), n + 1), m, n) >= 0) {
+        sub<Digits>(r.data(), r.data(), n + 1, m, n);
+    }
+
+    for(size_t i = 0; i < n; ++i) {
+        out[i] = r[i];
+    }
+}
+
+// window size for sliding window exponentiation with an exponent of the
+// given number of bits
+inline size_t window_size(size_t bits) noexcept {
+    return bits <= 8 ? 1 : bits <= 24 ? 2 : bits <= 80 ? 3 : bits <= 240 ? 4 : bits <= 672 ? 5 : 6;
+}
+} // detail
+} // math
+} // gears
+
+#endif // GEARS_MATH_UINTX_MODULAR_HPP
@@ -0,0 +1,503 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef GEARS_MATH_UINTX_MULTIPLY_HPP
+#define GEARS_MATH_UINTX_MULTIPLY_HPP
+
+#include <gears/math/uintx/limbs.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Operand sizes, in limbs, at which multiplication switches algorithm.
+// The defaults were measured with 32-bit limbs.
+#ifndef GEARS_UINTX_SQR_THRESHOLD
+#define GEARS_UINTX_SQR_THRESHOLD 8
+#endif // GEARS_UINTX_SQR_THRESHOLD
+
+#ifndef GEARS_UINTX_KARATSUBA_THRESHOLD
+#define GEARS_UINTX_KARATSUBA_THRESHOLD 48
+#endif // GEARS_UINTX_KARATSUBA_THRESHOLD
+
+#ifndef GEARS_UINTX_TOOM3_THRESHOLD
+#define GEARS_UINTX_TOOM3_THRESHOLD 300
+#endif // GEARS_UINTX_TOOM3_THRESHOLD
+
+#ifndef GEARS_UINTX_NTT_THRESHOLD
+#define GEARS_UINTX_NTT_THRESHOLD 8000
+#endif // GEARS_UINTX_NTT_THRESHOLD
+
+namespace gears {
+namespace math {
+namespace detail {
+template<typename Digits, typename Digit>
+inline void mul(Digit* out, const Digit* a, size_t an, const Digit* b, size_t bn);
+
+template<typename Digits, typename Digit>
+inline void mul_n(Digit* out, const Digit* a, const Digit* b, size_t n);
+
+// out[0, n) += value, the carry out of out[n - 1] is dropped
+template<typename Digits, typename Digit>
+inline void accumulate(Digit* out, size_t n, const Digit* value, size_t size) {
+    if(size > n) {
+        size = n;
+    }
+
+    Digit carry = add<Digits>(out, out, size, value, size);
+    add_1<Digits>(out + size, n - size, carry);
+}
+
+// out = a * b for operands of n limbs. From GEARS_UINTX_SQR_THRESHOLD limbs
+// up, squares compute every cross product only once.
+template<typename Digits, typename Digit>
+inline void mul_n_basecase(Digit* out, const Digit* a, const Digit* b, size_t n) noexcept {
+    if(a == b && n >= GEARS_UINTX_SQR_THRESHOLD) {
+        sqr_basecase<Digits>(out, a, n);
+    }
+    else {
+        mul_basecase<Digits>(out, a, n, b, n);
+    }
+}
+
+// Karatsuba needs |a1 - a0|, |b1 - b0|, their product and the middle
+// coefficient for every level of the recursion.
+constexpr size_t karatsuba_scratch(size_t n) {
+    return n < GEARS_UINTX_KARATSUBA_THRESHOLD ? 0 : 6 * (n - n / 2) + 1 + karatsuba_scratch(n - n / 2);
+}
+
+// out = a * b where both operands have n limbs, out holds 2n limbs. When
+// a and b are the same pointer every product in the recursion is a square.
+template<typename Digits, typename Digit>
+inline void karatsuba(Digit* out, const Digit* a, const Digit* b, size_t n, Digit* scratch) {
+    if(n < GEARS_UINTX_KARATSUBA_THRESHOLD) {
+        mul_n_basecase<Digits>(out, a, b, n);
+        return;
+    }
+
+    const size_t low = n / 2;
+    const size_t high = n - low;
+    Digit* da = scratch;
+    Digit* db = da + high;
+    Digit* product = db + high;
+    Digit* middle = product + 2 * high;
+    Digit* next = middle + 2 * high + 1;
+
+    // z0 and z2 go straight into their final position
+    karatsuba<Digits>(out, a, b, low, next);
+    karatsuba<Digits>(out + 2 * low, a + low, b + low, high, next);
+
+    // |a1 - a0| and |b1 - b0|, keeping track of the sign of the product
+    bool negative = false;
+    for(size_t i = 0; i < high; ++i) {
+        da[i] = db[i] = 0;
+    }
+
+    if(compare(a + low, trim(a + low, high), a, trim(a, low)) >= 0) {
+        sub<Digits>(da, a + low, high, a, low);
+    }
+    else {
+        sub<Digits>(da, a, low, a + low, trim(a + low, high));
+        negative = !negative;
+    }
+
+    if(a == b) {
+        db = da;
+        negative = false;
+    }
+    else if(compare(b + low, trim(b + low, high), b, trim(b, low)) >= 0) {
+        sub<Digits>(db, b + low, high, b, low);
+    }
+    else {
+        sub<Digits>(db, b, low, b + low, trim(b + low, high));
+        negative = !negative;
+    }
+
+    karatsuba<Digits>(product, da, db, high, next);
+
+    // middle = z0 + z2 -/+ (a1 - a0)(b1 - b0)
+    const size_t middle_size = 2 * high + 1;
+    for(size_t i = 0; i < middle_size; ++i) {
+        middle[i] = 0;
+    }
+    accumulate<Digits>(middle, middle_size, out + 2 * low, 2 * high);
+    accumulate<Digits>(middle, middle_size, out, 2 * low);
+
+    if(negative) {
+        accumulate<Digits>(middle, middle_size, product, 2 * high);
+    }
+    else {
+        sub<Digits>(middle, middle, middle_size, product, 2 * high);
+    }
+
+    accumulate<Digits>(out + low, 2 * n - low, middle, trim(middle, middle_size));
+}
+
+// Toom-3 works with signed intermediate values so it keeps them as a
+// sign and a normalised magnitude.
+template<typename Digit>
+struct signed_limbs {
+    std::vector<Digit> limbs;
+    bool negative;
+};
+
+template<typename Digit>
+inline signed_limbs<Digit> make_signed_limbs(const Digit* a, size_t n) {
+    return { std::vector<Digit>(a, a + trim(a, n)), false };
+}
+
+template<typename Digits, typename Digit>
+inline signed_limbs<Digit> add_signed(const signed_limbs<Digit>& a, const signed_limbs<Digit>& b, bool subtract = false) {
+    const bool b_negative = b.negative != subtract;
+    const auto& x = a.limbs;
+    const auto& y = b.limbs;
+    signed_limbs<Digit> result;
+
+    if(a.negative == b_negative) {
+        const auto& big = x.size() >= y.size() ? x : y;
+        const auto& small = x.size() >= y.size() ? y : x;
+        result.limbs.resize(big.size() + 1);
+        result.limbs.back() = add<Digits>(result.limbs.data(), big.data(), big.size(), small.data(), small.size());
+        result.negative = a.negative;
+    }
+    else if(compare(x.data(), x.size(), y.data(), y.size()) >= 0) {
+        result.limbs.resize(x.size());
+        sub<Digits>(result.limbs.data(), x.data(), x.size(), y.data(), y.size());
+        result.negative = a.negative;
+    }
+    else {
+        result.limbs.resize(y.size());
+        sub<Digits>(result.limbs.data(), y.data(), y.size(), x.data(), x.size());
+        result.negative = b_negative;
+    }
+
+    result.limbs.resize(trim(result.limbs.data(), result.limbs.size()));
+    result.negative = result.negative && !result.limbs.empty();
+    return result;
+}
+
+template<typename Digits, typename Digit>
+inline signed_limbs<Digit> mul_signed(const signed_limbs<Digit>& a, const signed_limbs<Digit>& b) {
+    signed_limbs<Digit> result = { std::vector<Digit>(), a.negative != b.negative };
+    if(a.limbs.empty() || b.limbs.empty()) {
+        result.negative = false;
+        return result;
+    }
+
+    result.limbs.resize(a.limbs.size() + b.limbs.size());
+    if(a.limbs.size() >= b.limbs.size()) {
+        mul<Digits>(result.limbs.data(), a.limbs.data(), a.limbs.size(), b.limbs.data(), b.limbs.size());
+    }
+    else {
+        mul<Digits>(result.limbs.data(), b.limbs.data(), b.limbs.size(), a.limbs.data(), a.limbs.size());
+    }
+    result.limbs.resize(trim(result.limbs.data(), result.limbs.size()));
+    return result;
+}
+
+template<typename Digits, typename Digit>
+inline void scale_signed(signed_limbs<Digit>& a, Digit k) {
+    Digit carry = mul_1<Digits>(a.limbs.data(), a.limbs.data(), a.limbs.size(), k);
+    if(carry) {
+        a.limbs.push_back(carry);
+    }
+}
+
+// exact division by a single limb
+template<typename Digits, typename Digit>
+inline void divide_signed(signed_limbs<Digit>& a, Digit d) {
+    divrem_1<Digits>(a.limbs.data(), a.limbs.data(), a.limbs.size(), d);
+    a.limbs.resize(trim(a.limbs.data(), a.limbs.size()));
+    a.negative = a.negative && !a.limbs.empty();
+}
+
+// out = a * b where both operands have n limbs, out holds 2n limbs. This uses
+// the evaluation points 0, 1, -1, -2 and infinity with Bodrato's interpolation.
+template<typename Digits, typename Digit>
+inline void toom3(Digit* out, const Digit* a, const Digit* b, size_t n) {
+    const size_t k = (n + 2) / 3;
+    const size_t last = n - 2 * k;
+
+    auto a0 = make_signed_limbs(a, k);
+    auto a1 = make_signed_limbs(a + k, k);
+    auto a2 = make_signed_limbs(a + 2 * k, last);
+    auto b0 = make_signed_limbs(b, k);
+    auto b1 = make_signed_limbs(b + k, k);
+    auto b2 = make_signed_limbs(b + 2 * k, last);
+
+    // p(1) = p0 + p1 + p2, p(-1) = p0 - p1 + p2, p(-2) = 2(p(-1) + p2) - p0
+    auto t = add_signed<Digits>(a0, a2);
+    auto pa1 = add_signed<Digits>(t, a1);
+    auto pam1 = add_signed<Digits>(t, a1, true);
+    auto pam2 = add_signed<Digits>(pam1, a2);
+    scale_signed<Digits>(pam2, Digit(2));
+    pam2 = add_signed<Digits>(pam2, a0, true);
+
+    t = add_signed<Digits>(b0, b2);
+    auto pb1 = add_signed<Digits>(t, b1);
+    auto pbm1 = add_signed<Digits>(t, b1, true);
+    auto pbm2 = add_signed<Digits>(pbm1, b2);
+    scale_signed<Digits>(pbm2, Digit(2));
+    pbm2 = add_signed<Digits>(pbm2, b0, true);
+
+    auto r0 = mul_signed<Digits>(a0, b0);
+    auto r1 = mul_signed<Digits>(pa1, pb1);
+    auto rm1 = mul_signed<Digits>(pam1, pbm1);
+    auto rm2 = mul_signed<Digits>(pam2, pbm2);
+    auto rinf = mul_signed<Digits>(a2, b2);
+
+    // interpolation
+    auto r3 = add_signed<Digits>(rm2, r1, true);
+    divide_signed<Digits>(r3, Digit(3));
+    r1 = add_signed<Digits>(r1, rm1, true);
+    divide_signed<Digits>(r1, Digit(2));
+    auto r2 = add_signed<Digits>(rm1, r0, true);
+    r3 = add_signed<Digits>(r2, r3, true);
+    divide_signed<Digits>(r3, Digit(2));
+    t = rinf;
+    scale_signed<Digits>(t, Digit(2));
+    r3 = add_signed<Digits>(r3, t);
+    r2 = add_signed<Digits>(r2, r1);
+    r2 = add_signed<Digits>(r2, rinf, true);
+    r1 = add_signed<Digits>(r1, r3, true);
+
+    const size_t size = 2 * n;
+    for(size_t i = 0; i < size; ++i) {
+        out[i] = 0;
+    }
+
+    const signed_limbs<Digit>* coefficients[] = { &r0, &r1, &r2, &r3, &rinf };
+    for(size_t i = 0; i < 5; ++i) {
+        const auto& c = coefficients[i]->limbs;
+        accumulate<Digits>(out + i * k, size - i * k, c.data(), c.size());
+    }
+}
+
+// Number theoretic transforms modulo two primes with 3 as a primitive root.
+// Operands are cut into 16-bit pieces so every coefficient of the
+// convolution stays below the product of the primes, which lets a single
+// step of Garner's algorithm recover it exactly.
+constexpr std::uint32_t ntt_first_prime = 998244353;  // 119 * 2^23 + 1
+constexpr std::uint32_t ntt_second_prime = 167772161; // 5 * 2^25 + 1
+constexpr size_t ntt_max_length = size_t(1) << 23;
+
+template<std::uint32_t Mod>
+inline std::uint32_t pow_mod(std::uint32_t base, std::uint64_t exponent) noexcept {
+    std::uint64_t result = 1;
+    std::uint64_t b = base;
+    while(exponent) {
+        if(exponent & 1) {
+            result = result * b % Mod;
+        }
+        b = b * b % Mod;
+        exponent >>= 1;
+    }
+    return static_cast<std::uint32_t>(result);
+}
+
+template<std::uint32_t Mod>
+inline void ntt(std::vector<std::uint32_t>& a, bool invert) {
+    const size_t n = a.size();
+
+    for(size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for(; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+
+        if(i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+
+    // the roots for the stage of size 2h live in [h, 2h) along with their
+    // Shoup companions floor(w * 2^32 / Mod) so a butterfly needs no division
+    std::vector<std::uint32_t> roots(n);
+    std::vector<std::uint32_t> companions(n);
+    for(size_t half = 1; half < n; half <<= 1) {
+        std::uint32_t w = pow_mod<Mod>(3, (Mod - 1) / (2 * half));
+        if(invert) {
+            w = pow_mod<Mod>(w, Mod - 2);
+        }
+
+        roots[half] = 1;
+        for(size_t j = 1; j < half; ++j) {
+            roots[half + j] = static_cast<std::uint32_t>(std::uint64_t(roots[half + j - 1]) * w % Mod);
+        }
+    }
+
+    for(size_t i = 1; i < n; ++i) {
+        companions[i] = static_cast<std::uint32_t>((std::uint64_t(roots[i]) << 32) / Mod);
+    }
+
+    for(size_t half = 1; half < n; half <<= 1) {
+        const std::uint32_t* w = roots.data() + half;
+        const std::uint32_t* companion = companions.data() + half;
+        for(size_t i = 0; i < n; i += 2 * half) {
+            std::uint32_t* low = a.data() + i;
+            std::uint32_t* high = low + half;
+            for(size_t j = 0; j < half; ++j) {
+                std::uint32_t x = high[j];
+                std::uint32_t q = static_cast<std::uint32_t>((std::uint64_t(x) * companion[j]) >> 32);
+                std::uint32_t v = x * w[j] - q * Mod;
+                v = v >= Mod ? v - Mod : v;
+                std::uint32_t u = low[j];
+                low[j] = u + v < Mod ? u + v : u + v - Mod;
+                high[j] = u >= v ? u - v : u + Mod - v;
+            }
+        }
+    }
+
+    if(invert) {
+        const std::uint64_t inverse = pow_mod<Mod>(static_cast<std::uint32_t>(n % Mod), Mod - 2);
+        for(auto&& x : a) {
+            x = static_cast<std::uint32_t>(x * inverse % Mod);
+        }
+    }
+}
+
+template<std::uint32_t Mod>
+inline std::vector<std::uint32_t> ntt_convolve(std::vector<std::uint32_t> x, std::vector<std::uint32_t> y) {
+    ntt<Mod>(x, false);
+    ntt<Mod>(y, false);
+    for(size_t i = 0; i < x.size(); ++i) {
+        x[i] = static_cast<std::uint32_t>(std::uint64_t(x[i]) * y[i] % Mod);
+    }
+    ntt<Mod>(x, true);
+    return x;
+}
+
+template<typename Digit>
+constexpr size_t ntt_pieces() noexcept {
+    return limb_bits<Digit>() % 16 == 0 ? limb_bits<Digit>() / 16 : 0;
+}
+
+template<typename Digit>
+inline size_t ntt_length(size_t an, size_t bn) noexcept {
+    size_t length = 1;
+    while(length < (an + bn) * ntt_pieces<Digit>()) {
+        length <<= 1;
+    }
+    return length;
+}
+
+template<typename Digit>
+inline std::vector<std::uint32_t> ntt_split(const Digit* a, size_t n, size_t length) {
+    std::vector<std::uint32_t> result(length);
+    for(size_t i = 0; i < n; ++i) {
+        for(size_t j = 0; j < ntt_pieces<Digit>(); ++j) {
+            result[i * ntt_pieces<Digit>() + j] = static_cast<std::uint32_t>((a[i] >> (16 * j)) & 0xFFFF);
+        }
+    }
+    return result;
+}
+
+// out = a * b, out holds an + bn limbs
+template<typename Digits, typename Digit>
+inline void ntt_mul(Digit* out, const Digit* a, size_t an, const Digit* b, size_t bn) {
+    const size_t length = ntt_length<Digit>(an, bn);
+    auto x = ntt_split(a, an, length);
+    auto y = ntt_split(b, bn, length);
+    auto first = ntt_convolve<ntt_first_prime>(x, y);
+    auto second = ntt_convolve<ntt_second_prime>(std::move(x), std::move(y));
+
+    const std::uint64_t inverse = pow_mod<ntt_second_prime>(ntt_first_prime % ntt_second_prime, ntt_second_prime - 2);
+    const size_t size = an + bn;
+    for(size_t i = 0; i < size; ++i) {
+        out[i] = 0;
+    }
+
+    std::uint64_t carry = 0;
+    for(size_t i = 0; i < size * ntt_pieces<Digit>(); ++i) {
+        // Garner: x = r0 + m0 * ((r1 - r0) / m0 mod m1)
+        std::uint64_t r0 = first[i];
+        std::uint64_t difference = (second[i] + ntt_second_prime - r0 % ntt_second_prime) % ntt_second_prime;
+        std::uint64_t v = difference * inverse % ntt_second_prime;
+        carry += r0 + v * ntt_first_prime;
+        out[i / ntt_pieces<Digit>()] |= static_cast<Digit>(static_cast<Digit>(carry & 0xFFFF) << (16 * (i % ntt_pieces<Digit>())));
+        carry >>= 16;
+    }
+}
+
+template<typename Digit>
+inline bool use_ntt(size_t an, size_t bn) noexcept {
+    return ntt_pieces<Digit>() != 0 && bn >= GEARS_UINTX_NTT_THRESHOLD && (an + bn) * ntt_pieces<Digit>() <= ntt_max_length;
+}
+
+// out = a * b where both operands have n limbs, out holds 2n limbs
+template<typename Digits, typename Digit>
+inline void mul_n(Digit* out, const Digit* a, const Digit* b, size_t n) {
+    if(n < GEARS_UINTX_KARATSUBA_THRESHOLD) {
+        mul_n_basecase<Digits>(out, a, b, n);
+    }
+    else if(use_ntt<Digit>(n, n)) {
+        ntt_mul<Digits>(out, a, n, b, n);
+    }
+    else if(n < GEARS_UINTX_TOOM3_THRESHOLD) {
+        std::vector<Digit> scratch(karatsuba_scratch(n));
+        karatsuba<Digits>(out, a, b, n, scratch.data());
+    }
+    else {
+        toom3<Digits>(out, a, b, n);
+    }
+}
+
+// out = a * b, requires an >= bn > 0 and out to hold an + bn limbs without
+// aliasing either operand.
+template<typename Digits, typename Digit>
+inline void mul(Digit* out, const Digit* a, size_t an, const Digit* b, size_t bn) {
+    if(an == bn) {
+        mul_n<Digits>(out, a, b, bn);
+        return;
+    }
+
+    if(bn < GEARS_UINTX_KARATSUBA_THRESHOLD) {
+        mul_basecase<Digits>(out, a, an, b, bn);
+        return;
+    }
+
+    if(use_ntt<Digit>(an, bn)) {
+        ntt_mul<Digits>(out, a, an, b, bn);
+        return;
+    }
+
+    // unbalanced operands are cut into bn sized pieces of a
+    std::vector<Digit> product(2 * bn);
+    for(size_t i = 0; i < an + bn; ++i) {
+        out[i] = 0;
+    }
+
+    for(size_t offset = 0; offset < an; offset += bn) {
+        const size_t size = an - offset < bn ? an - offset : bn;
+        if(size == bn) {
+            mul_n<Digits>(product.data(), a + offset, b, bn);
+        }
+        else {
+            mul<Digits>(product.data(), b, bn, a + offset, size);
+        }
+        accumulate<Digits>(out + offset, an + bn - offset, product.data(), size + bn);
+    }
+}
+} // detail
+} // math
+} // gears
+
+#endif // GEARS_MATH_UINTX_MULTIPLY_HPP
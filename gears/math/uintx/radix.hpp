@@ -0,0 +1,259 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef GEARS_MATH_UINTX_RADIX_HPP
+#define GEARS_MATH_UINTX_RADIX_HPP
+
+#include <gears/math/uintx/limbs.hpp>
+#include <gears/math/uintx/divide.hpp>
+#include <cmath>
+#include <vector>
+
+// Size, in limbs, below which radix conversion uses the quadratic method
+// instead of splitting the number in halves.
+#ifndef GEARS_UINTX_RADIX_THRESHOLD
+#define GEARS_UINTX_RADIX_THRESHOLD 30
+#endif // GEARS_UINTX_RADIX_THRESHOLD
+
+namespace gears {
+namespace math {
+namespace detail {
+inline char radix_char(unsigned value) noexcept {
+    return "0123456789abcdefghijklmnopqrstuvwxyz"[value];
+}
+
+// the value of a digit in bases up to 36, or 36 if c is not a digit
+inline unsigned radix_value(char c) noexcept {
+    return c >= '0' && c <= '9' ? static_cast<unsigned>(c - '0') :
+           c >= 'a' && c <= 'z' ? static_cast<unsigned>(c - 'a' + 10) :
+           c >= 'A' && c <= 'Z' ? static_cast<unsigned>(c - 'A' + 10) : 36;
+}
+
+// A radix together with the largest power of it that fits in a limb. The
+// powers chunk^(2^i) used to split numbers in halves are computed lazily.
+template<typename Digit>
+struct radix {
+    unsigned base;
+    unsigned shift; // log2(base) for powers of two, 0 otherwise
+    size_t chunk_digits;
+    Digit chunk;
+    std::vector<std::vector<Digit>> powers;
+
+    explicit radix(unsigned base): base(base), shift(0), chunk_digits(1), chunk(static_cast<Digit>(base)) {
+        if((base & (base - 1)) == 0) {
+            while((1u << shift) < base) {
+                ++shift;
+            }
+        }
+
+        while(chunk <= Digit(~Digit(0)) / base) {
+            chunk = static_cast<Digit>(chunk * base);
+            ++chunk_digits;
+        }
+    }
+
+    // chunk^(2^level), which stands for chunk_digits << level digits
+    template<typename Digits>
+    const std::vector<Digit>& power(size_t level) {
+        if(powers.empty()) {
+            powers.emplace_back(1, chunk);
+        }
+
+        while(powers.size() <= level) {
+            auto square = multiply<Digits>(powers.back().data(), powers.back().size(), powers.back().data(), powers.back().size());
+            powers.push_back(std::move(square));
+        }
+        return powers[level];
+    }
+
+    // an upper bound of the number of digits needed for a value of bits bits
+    size_t digits(size_t bits) const {
+        if(shift) {
+            return (bits + shift - 1) / shift;
+        }
+        return static_cast<size_t>(static_cast<double>(bits) / std::log2(static_cast<double>(base))) + 2;
+    }
+};
+
+// Writes a, which has n limbs, as exactly length digits into out padded
+// with zeros on the left. Requires a < base^length.
+template<typename Digit>
+inline void to_radix_power2(char* out, size_t length, const Digit* a, size_t n, unsigned shift) noexcept {
+    const size_t bits = limb_bits<Digit>();
+    const Digit mask = static_cast<Digit>((Digit(1) << shift) - 1);
+    for(size_t i = 0; i < length; ++i) {
+        const size_t bit = i * shift;
+        const size_t index = bit / bits;
+        const unsigned offset = bit % bits;
+        Digit value = index < n ? static_cast<Digit>(a[index] >> offset) : Digit(0);
+        if(offset + shift > bits && index + 1 < n) {
+            value = static_cast<Digit>(value | (a[index + 1] << (bits - offset)));
+        }
+        out[length - 1 - i] = radix_char(value & mask);
+    }
+}
+
+template<typename Digits, typename Digit>
+inline void to_radix_basecase(char* out, size_t length, const Digit* a, size_t n, const radix<Digit>& r) {
+    std::vector<Digit> copy(a, a + n);
+    char* end = out + length;
+    while(n > 0 && end != out) {
+        Digit rest = divrem_1<Digits>(copy.data(), copy.data(), n, r.chunk);
+        n = trim(copy.data(), n);
+        for(size_t i = 0; i < r.chunk_digits && end != out; ++i) {
+            *--end = radix_char(static_cast<unsigned>(rest % r.base));
+            rest = static_cast<Digit>(rest / r.base);
+        }
+    }
+
+    while(end != out) {
+        *--end = '0';
+    }
+}
+
+// Same contract as to_radix_power2 for any base. Numbers are split by the
+// largest power chunk^(2^i) with at most half their limbs and both halves
+// are converted independently.
+template<typename Digits, typename Digit>
+inline void to_radix(char* out, size_t length, const Digit* a, size_t n, radix<Digit>& r) {
+    n = trim(a, n);
+    if(r.shift) {
+        to_radix_power2(out, length, a, n, r.shift);
+        return;
+    }
+
+    if(n < GEARS_UINTX_RADIX_THRESHOLD || n < 2) {
+        to_radix_basecase<Digits>(out, length, a, n, r);
+        return;
+    }
+
+    size_t level = 0;
+    while(r.template power<Digits>(level + 1).size() <= (n + 1) / 2) {
+        ++level;
+    }
+
+    const auto& divisor = r.template power<Digits>(level);
+    const size_t size = divisor.size();
+    const size_t low = r.chunk_digits << level;
+    std::vector<Digit> quotient(n - size + 1);
+    std::vector<Digit> remainder(size);
+    std::vector<Digit> scratch(n + size + 1);
+    divrem<Digits>(quotient.data(), remainder.data(), a, n, divisor.data(), size, scratch.data());
+    scratch = std::vector<Digit>();
+
+    to_radix<Digits>(out, length - low, quotient.data(), quotient.size(), r);
+    to_radix<Digits>(out + length - low, low, remainder.data(), remainder.size(), r);
+}
+
+// Parses length digits that are valid in the base into out.
+template<typename Digit>
+inline void from_radix_power2(std::vector<Digit>& out, const char* s, size_t length, unsigned shift) {
+    const size_t bits = limb_bits<Digit>();
+    out.assign((length * shift + bits - 1) / bits, Digit(0));
+    for(size_t i = 0; i < length; ++i) {
+        const Digit value = static_cast<Digit>(radix_value(s[length - 1 - i]));
+        const size_t bit = i * shift;
+        const size_t index = bit / bits;
+        const unsigned offset = bit % bits;
+        out[index] = static_cast<Digit>(out[index] | (value << offset));
+        if(offset + shift > bits) {
+            out[index + 1] = static_cast<Digit>(out[index + 1] | (value >> (bits - offset)));
+        }
+    }
+    out.resize(trim(out.data(), out.size()));
+}
+
+template<typename Digits, typename Digit>
+inline void from_radix_basecase(std::vector<Digit>& out, const char* s, size_t length, const radix<Digit>& r) {
+    out.clear();
+    out.reserve(length / r.chunk_digits + 1);
+    size_t position = 0;
+    size_t count = length % r.chunk_digits == 0 ? r.chunk_digits : length % r.chunk_digits;
+
+    while(position != length) {
+        Digit value = 0;
+        Digit multiplier = 1;
+        for(size_t i = 0; i < count; ++i) {
+            value = static_cast<Digit>(value * r.base + radix_value(s[position + i]));
+            multiplier = static_cast<Digit>(multiplier * r.base);
+        }
+
+        Digit carry = mul_1<Digits>(out.data(), out.data(), out.size(), multiplier, value);
+        if(carry) {
+            out.push_back(carry);
+        }
+
+        position += count;
+        count = r.chunk_digits;
+    }
+}
+
+// Parses length digits that are valid in the base into out. The digits are
+// split so the low part has chunk_digits << i digits and the result is
+// high * chunk^(2^i) + low.
+template<typename Digits, typename Digit>
+inline void from_radix(std::vector<Digit>& out, const char* s, size_t length, radix<Digit>& r) {
+    if(r.shift) {
+        from_radix_power2(out, s, length, r.shift);
+        return;
+    }
+
+    if(length <= r.chunk_digits * GEARS_UINTX_RADIX_THRESHOLD) {
+        from_radix_basecase<Digits>(out, s, length, r);
+        return;
+    }
+
+    size_t level = 0;
+    while((r.chunk_digits << (level + 1)) <= length / 2) {
+        ++level;
+    }
+
+    const size_t low = r.chunk_digits << level;
+    std::vector<Digit> high;
+    std::vector<Digit> rest;
+    from_radix<Digits>(high, s, length - low, r);
+    from_radix<Digits>(rest, s + length - low, low, r);
+
+    const auto& power = r.template power<Digits>(level);
+    out = multiply<Digits>(high.data(), high.size(), power.data(), power.size());
+    increase<Digits>(out, rest.data(), rest.size());
+    out.resize(trim(out.data(), out.size()));
+}
+
+// a as a string of digits in the base without leading zeros
+template<typename Digits, typename Digit>
+inline std::string to_radix_string(const Digit* a, size_t n, unsigned base) {
+    n = trim(a, n);
+    if(n == 0) {
+        return "0";
+    }
+
+    radix<Digit> r(base);
+    std::string result(r.digits(bit_length(a, n)), '0');
+    to_radix<Digits>(&result[0], result.size(), a, n, r);
+    result.erase(0, result.find_first_not_of('0'));
+    return result;
+}
+} // detail
+} // math
+} // gears
+
+#endif // GEARS_MATH_UINTX_RADIX_HPP
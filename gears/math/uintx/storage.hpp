@@ -0,0 +1,369 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef GEARS_MATH_UINTX_STORAGE_HPP
+#define GEARS_MATH_UINTX_STORAGE_HPP
+
+#include <gears/math/uintx/limbs.hpp>
+#include <gears/meta/indices.hpp>
+#include <array>
+#include <utility>
+
+// Bounded uintx up to this many bits keep their limbs inline.
+#ifndef GEARS_UINTX_MAX_INLINE_BITS
+#define GEARS_UINTX_MAX_INLINE_BITS 4096
+#endif // GEARS_UINTX_MAX_INLINE_BITS
+
+// Arbitrary precision uintx keep this many limbs inline before allocating.
+#ifndef GEARS_UINTX_SMALL_LIMBS
+#define GEARS_UINTX_SMALL_LIMBS 4
+#endif // GEARS_UINTX_SMALL_LIMBS
+
+namespace gears {
+namespace math {
+namespace detail {
+// Both storage policies provide the subset of the std::vector interface that
+// uintx uses. The limbs past size() are unspecified.
+
+// Inline storage for at most N limbs. Growing past N silently drops the
+// extra limbs, which is the truncation bounded precision wants anyway. The
+// top limb is masked with Mask when constructed from an integer.
+template<typename Digit, size_t N, Digit Mask = Digit(~Digit(0))>
+struct fixed_storage {
+private:
+    std::array<Digit, N> limbs;
+    size_t length;
+
+    template<typename T>
+    static constexpr Digit limb(T value, size_t index) noexcept {
+        return static_cast<Digit>(shift_right(value, index * limb_bits<Digit>()) & (index == N - 1 ? Mask : Digit(~Digit(0))));
+    }
+
+    template<typename T>
+    static constexpr size_t used(T value, size_t n) noexcept {
+        return n == 0 ? 0 : limb(value, n - 1) != 0 ? n : used(value, n - 1);
+    }
+
+    template<typename T, size_t... I>
+    constexpr fixed_storage(T value, meta::detail::indices<I...>) noexcept: limbs{{ limb(value, I)... }}, length(used(value, N)) {}
+public:
+    constexpr fixed_storage() noexcept: limbs(), length(0) {}
+
+    template<typename T>
+    constexpr explicit fixed_storage(T value) noexcept: fixed_storage(value, typename meta::detail::build_indices<N>::type{}) {}
+
+    Digit* data() noexcept {
+        return limbs.data();
+    }
+
+    const Digit* data() const noexcept {
+        return limbs.data();
+    }
+
+    constexpr size_t size() const noexcept {
+        return length;
+    }
+
+    constexpr bool empty() const noexcept {
+        return length == 0;
+    }
+
+    Digit& operator[](size_t index) noexcept {
+        return limbs[index];
+    }
+
+    const Digit& operator[](size_t index) const noexcept {
+        return limbs[index];
+    }
+
+    Digit& back() noexcept {
+        return limbs[length - 1];
+    }
+
+    const Digit& back() const noexcept {
+        return limbs[length - 1];
+    }
+
+    void clear() noexcept {
+        length = 0;
+    }
+
+    void reserve(size_t) noexcept {}
+
+    void resize(size_t n, Digit value = Digit(0)) noexcept {
+        n = n < N ? n : N;
+        for(size_t i = length; i < n; ++i) {
+            limbs[i] = value;
+        }
+        length = n;
+    }
+
+    void push_back(Digit value) noexcept {
+        if(length < N) {
+            limbs[length++] = value;
+        }
+    }
+
+    void pop_back() noexcept {
+        --length;
+    }
+
+    void swap(fixed_storage& other) noexcept {
+        using std::swap;
+        swap(limbs, other.limbs);
+        swap(length, other.length);
+    }
+
+    friend bool operator==(const fixed_storage& lhs, const fixed_storage& rhs) noexcept {
+        if(lhs.length != rhs.length) {
+            return false;
+        }
+
+        for(size_t i = 0; i < lhs.length; ++i) {
+            if(lhs.limbs[i] != rhs.limbs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const fixed_storage& lhs, const fixed_storage& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+};
+
+// Storage for arbitrary precision. Up to N limbs are kept inline and only
+// larger values spill to the heap, so copies and moves of small values do
+// not allocate. The heap buffer is kept when the value shrinks again.
+template<typename Digit, size_t N = GEARS_UINTX_SMALL_LIMBS>
+struct dynamic_storage {
+private:
+    static_assert(N > 0, "The inline buffer must hold at least one limb");
+
+    Digit* heap;
+    size_t length;
+    size_t capacity;
+    Digit small[N];
+
+    bool is_small() const noexcept {
+        return capacity == N;
+    }
+
+    void release() noexcept {
+        if(!is_small()) {
+            delete[] heap;
+            heap = nullptr;
+            capacity = N;
+        }
+    }
+
+    void assign(const Digit* limbs, size_t n) {
+        reserve(n);
+        Digit* buffer = data();
+        for(size_t i = 0; i < n; ++i) {
+            buffer[i] = limbs[i];
+        }
+        length = n;
+    }
+
+    void steal(dynamic_storage& other) noexcept {
+        if(other.is_small()) {
+            // the inline buffer of this object is at least as big
+            Digit* buffer = data();
+            for(size_t i = 0; i < other.length; ++i) {
+                buffer[i] = other.small[i];
+            }
+        }
+        else {
+            heap = other.heap;
+            capacity = other.capacity;
+            other.heap = nullptr;
+            other.capacity = N;
+        }
+        length = other.length;
+        other.length = 0;
+    }
+public:
+    dynamic_storage() noexcept: heap(nullptr), length(0), capacity(N) {}
+
+    template<typename T>
+    explicit dynamic_storage(T value): dynamic_storage() {
+        while(value) {
+            push_back(static_cast<Digit>(value));
+            value = shift_right(value, limb_bits<Digit>());
+        }
+    }
+
+    dynamic_storage(const dynamic_storage& other): dynamic_storage() {
+        assign(other.data(), other.length);
+    }
+
+    dynamic_storage(dynamic_storage&& other) noexcept: dynamic_storage() {
+        steal(other);
+    }
+
+    dynamic_storage& operator=(const dynamic_storage& other) {
+        if(this != &other) {
+            assign(other.data(), other.length);
+        }
+        return *this;
+    }
+
+    dynamic_storage& operator=(dynamic_storage&& other) noexcept {
+        if(this != &other) {
+            if(!other.is_small()) {
+                release();
+            }
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~dynamic_storage() {
+        release();
+    }
+
+    Digit* data() noexcept {
+        return is_small() ? small : heap;
+    }
+
+    const Digit* data() const noexcept {
+        return is_small() ? small : heap;
+    }
+
+    size_t size() const noexcept {
+        return length;
+    }
+
+    bool empty() const noexcept {
+        return length == 0;
+    }
+
+    Digit& operator[](size_t index) noexcept {
+        return data()[index];
+    }
+
+    const Digit& operator[](size_t index) const noexcept {
+        return data()[index];
+    }
+
+    Digit& back() noexcept {
+        return data()[length - 1];
+    }
+
+    const Digit& back() const noexcept {
+        return data()[length - 1];
+    }
+
+    void clear() noexcept {
+        length = 0;
+    }
+
+    void reserve(size_t n) {
+        if(n <= capacity) {
+            return;
+        }
+
+        const size_t grown = 2 * capacity;
+        const size_t size = n < grown ? grown : n;
+        Digit* buffer = new Digit[size];
+        const Digit* old = data();
+        for(size_t i = 0; i < length; ++i) {
+            buffer[i] = old[i];
+        }
+
+        release();
+        heap = buffer;
+        capacity = size;
+    }
+
+    void resize(size_t n, Digit value = Digit(0)) {
+        reserve(n);
+        Digit* buffer = data();
+        for(size_t i = length; i < n; ++i) {
+            buffer[i] = value;
+        }
+        length = n;
+    }
+
+    void push_back(Digit value) {
+        if(length == capacity) {
+            reserve(length + 1);
+        }
+        data()[length++] = value;
+    }
+
+    void pop_back() noexcept {
+        --length;
+    }
+
+    void swap(dynamic_storage& other) noexcept {
+        if(!is_small() && !other.is_small()) {
+            using std::swap;
+            swap(heap, other.heap);
+            swap(length, other.length);
+            swap(capacity, other.capacity);
+            return;
+        }
+
+        dynamic_storage temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    friend bool operator==(const dynamic_storage& lhs, const dynamic_storage& rhs) noexcept {
+        return compare(lhs.data(), lhs.length, rhs.data(), rhs.length) == 0;
+    }
+
+    friend bool operator!=(const dynamic_storage& lhs, const dynamic_storage& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+};
+
+// Scratch space for the kernels, inline when the size is known up front.
+template<typename Digit, size_t N>
+struct scratch_buffer {
+    std::array<Digit, N> buffer;
+
+    explicit scratch_buffer(size_t) noexcept {}
+
+    Digit* data() noexcept {
+        return buffer.data();
+    }
+};
+
+template<typename Digit>
+struct scratch_buffer<Digit, 0> {
+    dynamic_storage<Digit, 2 * GEARS_UINTX_SMALL_LIMBS + 1> buffer;
+
+    explicit scratch_buffer(size_t n) {
+        buffer.resize(n);
+    }
+
+    Digit* data() noexcept {
+        return buffer.data();
+    }
+};
+} // detail
+} // math
+} // gears
+
+#endif // GEARS_MATH_UINTX_STORAGE_HPP
@@ -22,10 +22,13 @@
 #ifndef GEARS_UTILITY_BASE64_HPP
 #define GEARS_UTILITY_BASE64_HPP
 
+#include <gears/utility/base64/kernels.hpp>
+#include <gears/utility/base64/stream.hpp>
+#include <gears/utility/base64/parallel.hpp>
 #include <string>
-#include <unordered_map>
 #include <cstddef>
 #include <exception>
+#include <system_error>
 
 namespace gears {
 
@@ -43,144 +46,229 @@ public:
 };
 
 namespace base64 {
-namespace detail {
-const signed char npos = -1;
-} // detail
+/**
+ * @ingroup utility
+ * @brief The result of encoding or decoding into a buffer.
+ * @details The result of `encode` and `decode` into a caller provided
+ * buffer. On success `ptr` is one past the last character or byte written
+ * and `ec` is value-initialised. If the buffer is smaller than
+ * `encoded_size` or `decoded_size` asks for, nothing is written, `ptr` is
+ * the end of the buffer and `ec` is `std::errc::value_too_large`.
+ */
+struct buffer_result {
+    char* ptr;
+    std::errc ec;
+};
+
+/**
+ * @ingroup utility
+ * @brief Returns the number of characters needed to encode some bytes.
+ * @details Returns the length of the base64 encoding of `bytes` bytes,
+ * padding included, which is exactly what `encode` writes.
+ *
+ * @param bytes The number of bytes to encode.
+ * @return The number of characters of the encoding.
+ */
+inline size_t encoded_size(size_t bytes) noexcept {
+    return (bytes + 2) / 3 * 4;
+}
+
+/**
+ * @ingroup utility
+ * @brief Returns the number of bytes needed to decode some base64.
+ * @details Returns the number of bytes needed to decode `[first, last)`.
+ * Only the length and the trailing padding are looked at, so the result is
+ * exact when the input has no characters outside of the base64 alphabet
+ * besides the padding and an upper bound otherwise.
+ *
+ * @param first The beginning of the base64 characters.
+ * @param last The end of the base64 characters.
+ * @return The most bytes `decode` can write for the input.
+ */
+inline size_t decoded_size(const char* first, const char* last) noexcept {
+    for(int padding = 0; padding < 2 && last != first && *(last - 1) == '='; ++padding) {
+        --last;
+    }
+    const size_t size = static_cast<size_t>(last - first);
+    return size / 4 * 3 + (size % 4 == 0 ? 0 : size % 4 - 1);
+}
+
+/**
+ * @ingroup utility
+ * @brief Encodes bytes to base64 into a buffer.
+ * @details Encodes the bytes in `[first, last)` into the buffer
+ * `[out_first, out_last)`, which must hold at least `encoded_size(last - first)`
+ * characters. No null character is written and nothing is allocated, so a
+ * single buffer can be reused across calls. The encoding is the same as
+ * the string overload's.
+ *
+ * @param first The beginning of the bytes to encode.
+ * @param last The end of the bytes to encode.
+ * @param out_first The beginning of the buffer.
+ * @param out_last The end of the buffer.
+ * @return The end of the written characters and an error code.
+ */
+inline buffer_result encode(const char* first, const char* last, char* out_first, char* out_last) noexcept {
+    const size_t size = static_cast<size_t>(last - first);
+    if(static_cast<size_t>(out_last - out_first) < encoded_size(size)) {
+        return { out_last, std::errc::value_too_large };
+    }
+
+    detail::encode(reinterpret_cast<const unsigned char*>(first), size, out_first);
+    return { out_first + encoded_size(size), std::errc() };
+}
+
+/**
+ * @ingroup utility
+ * @brief Decodes base64 into a buffer.
+ * @details Decodes the characters in `[first, last)` into the buffer
+ * `[out_first, out_last)`, which must hold at least `decoded_size(first, last)`
+ * bytes. Nothing is allocated, so a single buffer can be reused across calls.
+ * Characters outside of the base64 alphabet are skipped like in the string
+ * overload. Bytes between the returned pointer and `out_first` plus
+ * `decoded_size` may be overwritten.
+ *
+ * @param first The beginning of the base64 characters.
+ * @param last The end of the base64 characters.
+ * @param out_first The beginning of the buffer.
+ * @param out_last The end of the buffer.
+ * @return The end of the written bytes and an error code.
+ */
+inline buffer_result decode(const char* first, const char* last, char* out_first, char* out_last) noexcept {
+    if(static_cast<size_t>(out_last - out_first) < decoded_size(first, last)) {
+        return { out_last, std::errc::value_too_large };
+    }
+
+    const size_t written = detail::decode(first, static_cast<size_t>(last - first), reinterpret_cast<unsigned char*>(out_first), static_cast<size_t>(out_last - out_first));
+    return { out_first + written, std::errc() };
+}
+
+/**
+ * @ingroup utility
+ * @brief Encodes bytes to base64 into a buffer on multiple threads.
+ * @details Encodes the same as the four parameter overload, but splits the
+ * input at multiples of 3 bytes into chunks of at least
+ * `GEARS_BASE64_PARALLEL_CHUNK` bytes (1 MiB unless defined before including
+ * the file) that are encoded straight into their place in the buffer on a
+ * pool of threads. Inputs smaller than a chunk are encoded on the calling
+ * thread.
+ *
+ * @param first The beginning of the bytes to encode.
+ * @param last The end of the bytes to encode.
+ * @param out_first The beginning of the buffer.
+ * @param out_last The end of the buffer.
+ * @param threads The number of threads to use, 0 means one per hardware thread.
+ * @return The end of the written characters and an error code.
+ */
+inline buffer_result encode(const char* first, const char* last, char* out_first, char* out_last, unsigned threads) {
+    const size_t size = static_cast<size_t>(last - first);
+    if(static_cast<size_t>(out_last - out_first) < encoded_size(size)) {
+        return { out_last, std::errc::value_too_large };
+    }
+
+    detail::parallel_encode(reinterpret_cast<const unsigned char*>(first), size, out_first, threads);
+    return { out_first + encoded_size(size), std::errc() };
+}
+
+/**
+ * @ingroup utility
+ * @brief Decodes base64 into a buffer on multiple threads.
+ * @details Decodes the same as the four parameter overload, but splits the
+ * input into chunks of at least `GEARS_BASE64_PARALLEL_CHUNK` characters
+ * that are decoded on a pool of threads. The characters of the alphabet in
+ * every chunk are counted on the threads first to find where its output
+ * goes, so input with line breaks is split like any other. Inputs smaller
+ * than a chunk are decoded on the calling thread.
+ *
+ * @param first The beginning of the base64 characters.
+ * @param last The end of the base64 characters.
+ * @param out_first The beginning of the buffer.
+ * @param out_last The end of the buffer.
+ * @param threads The number of threads to use, 0 means one per hardware thread.
+ * @return The end of the written bytes and an error code.
+ */
+inline buffer_result decode(const char* first, const char* last, char* out_first, char* out_last, unsigned threads) {
+    if(static_cast<size_t>(out_last - out_first) < decoded_size(first, last)) {
+        return { out_last, std::errc::value_too_large };
+    }
+
+    const size_t written = detail::parallel_decode(first, static_cast<size_t>(last - first), reinterpret_cast<unsigned char*>(out_first), threads);
+    return { out_first + written, std::errc() };
+}
 
 /**
  * @ingroup utility
  * @brief Encodes a string to base64.
- * @details Encodes a string to base64. The string to encode is
- * done byte by byte. Padding is done through character `=`. The character
- * for the 62nd index is + and the index for the 63rd index is
- * /. There is no line limit imposed.
+ * @details Encodes a string to base64. Padding is done through character
+ * `=`. The character for the 62nd index is + and the index for the 63rd
+ * index is /. There is no line limit imposed. The output is sized once up
+ * front and, on x86 processors that support them, filled 24 or 12 bytes at a
+ * time with AVX2 or SSSE3 instructions picked at runtime, with a table driven
+ * fallback everywhere else.
  *
  * @param str The string to encode.
  * @return base64 encoded string.
  */
 inline std::string encode(const std::string& str) {
-    size_t index = 0;
-    static auto read = [&index](const std::string& s) -> signed char {
-        if(index >= s.length() || s.empty()) {
-            return detail::npos;
-        }
-        signed char result = s[index++] & 0xFF;
-        return result;
-    };
-
-    static const char lookup[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-    std::string result;
-    signed char buffer[3]; // 24 bits
-
-    while(true) {
-        buffer[0] = read(str);
-        if(buffer[0] == detail::npos) {
-            break;
-        }
-
-        buffer[1] = read(str);
-        buffer[2] = read(str);
-
-        result += lookup[buffer[0] >> 2];
-        if(buffer[1] != detail::npos) {
-            result += lookup[((buffer[0] << 4) & 0x30) | (buffer[1] >> 4)];
-
-            if(buffer[2] != detail::npos) {
-                result += lookup[((buffer[1] << 2) & 0x3C) | (buffer[2] >> 6)];
-                result += lookup[buffer[2] & 0x3F];
-            }
-            else {
-                result += lookup[(buffer[1] << 2) & 0x3C];
-                result += '=';
-                break;
-            }
-        }
-        else {
-            result += lookup[(buffer[0] << 4) & 0x30];
-            result += "==";
-            break;
-        }
-    }
-
+    std::string result(encoded_size(str.size()), '\0');
+    encode(str.data(), str.data() + str.size(), &result[0], &result[0] + result.size());
     return result;
 }
 
 /**
  * @ingroup utility
  * @brief Decodes a string from base64.
- * @details Decodes a string from base64. If the input
- * string is not in base64 then a `gears::invalid_base64`
- * exception is thrown.
+ * @details Decodes a string from base64. Characters outside of the base64
+ * alphabet, such as padding and line breaks, are skipped. Like `encode`, the
+ * bulk of the input is decoded with AVX2 or SSSE3 instructions when the
+ * processor supports them.
  *
  * @param str The base64 string to decode.
- * @throws gears::invalid_base64 Thrown when the input string is invalid.
  * @return The decoded string
  */
 inline std::string decode(const std::string& str) {
-    size_t index = 0;
-
-    static std::unordered_map<char,int> lookup = {
-        {'A', 0},  {'B', 1},  {'C', 2},  {'D', 3},  {'E', 4},  {'F', 5},  {'G', 6},  {'H', 7}, {'I', 8},
-        {'J', 9},  {'K', 10}, {'L', 11}, {'M', 12}, {'N', 13}, {'O', 14}, {'P', 15}, {'Q', 16},
-        {'R', 17}, {'S', 18}, {'T', 19}, {'U', 20}, {'V', 21}, {'W', 22}, {'X', 23}, {'Y', 24},
-        {'Z', 25}, {'a', 26}, {'b', 27}, {'c', 28}, {'d', 29}, {'e', 30}, {'f', 31}, {'g', 32},
-        {'h', 33}, {'i', 34}, {'j', 35}, {'k', 36}, {'l', 37}, {'m', 38}, {'n', 39}, {'o', 40},
-        {'p', 41}, {'q', 42}, {'r', 43}, {'s', 44}, {'t', 45}, {'u', 46}, {'v', 47}, {'w', 48},
-        {'x', 49}, {'y', 50}, {'z', 51}, {'0', 52}, {'1', 53}, {'2', 54}, {'3', 55}, {'4', 56},
-        {'5', 57}, {'6', 58}, {'7', 59}, {'8', 60}, {'9', 61}, {'+', 62}, {'/', 63}
-    };
-
-    static auto read = [&](const std::string& st) -> signed char {
-        if(st.empty()) {
-            return detail::npos;
-        }
-
-        while(true) {
-            if(index > st.length()) {
-                return detail::npos;
-            }
-
-            auto next = st[index];
-            ++index;
-            auto it = lookup.find(next);
-            if(it != lookup.end()) {
-                return it->second;
-            }
-        }
-    };
-
-    char buffer[4];
-    std::string result;
-    while(true) {
-        buffer[0] = read(str);
-        if(buffer[0] == detail::npos) {
-            break;
-        }
-
-        buffer[1] = read(str);
-        if(buffer[1] == detail::npos) {
-            break;
-        }
-
-
-        buffer[2] = read(str);
-        buffer[3] = read(str);
-        result += ((buffer[0] << 2) & 0xFF) | (buffer[1] >> 4);
-
-        if(buffer[2] == detail::npos) {
-            break;
-        }
-
-        result += ((buffer[1] << 4) & 0xFF) | (buffer[2] >> 2);
-
-        if(buffer[3] == detail::npos) {
-            break;
-        }
-
-        result += ((buffer[2] << 6) & 0xFF) | buffer[3];
-    }
+    std::string result(decoded_size(str.data(), str.data() + str.size()), '\0');
+    auto end = decode(str.data(), str.data() + str.size(), &result[0], &result[0] + result.size()).ptr;
+    result.resize(static_cast<size_t>(end - result.data()));
+    return result;
+}
 
+/**
+ * @ingroup utility
+ * @brief Encodes a string to base64 on multiple threads.
+ * @details Encodes a string the same as the one parameter overload, with the
+ * work split across threads like the buffer overload taking `threads`.
+ *
+ * Example:
+ * @code
+ * std::string snapshot = read_snapshot();
+ * std::string encoded = base64::encode(snapshot, 0); // every hardware thread
+ * @endcode
+ *
+ * @param str The string to encode.
+ * @param threads The number of threads to use, 0 means one per hardware thread.
+ * @return base64 encoded string.
+ */
+inline std::string encode(const std::string& str, unsigned threads) {
+    std::string result(encoded_size(str.size()), '\0');
+    encode(str.data(), str.data() + str.size(), &result[0], &result[0] + result.size(), threads);
+    return result;
+}
+
+/**
+ * @ingroup utility
+ * @brief Decodes a string from base64 on multiple threads.
+ * @details Decodes a string the same as the one parameter overload, with the
+ * work split across threads like the buffer overload taking `threads`.
+ *
+ * @param str The base64 string to decode.
+ * @param threads The number of threads to use, 0 means one per hardware thread.
+ * @return The decoded string
+ */
+inline std::string decode(const std::string& str, unsigned threads) {
+    std::string result(decoded_size(str.data(), str.data() + str.size()), '\0');
+    auto end = decode(str.data(), str.data() + str.size(), &result[0], &result[0] + result.size(), threads).ptr;
+    result.resize(static_cast<size_t>(end - result.data()));
     return result;
 }
 } // base64
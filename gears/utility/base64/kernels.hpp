@@ -0,0 +1,366 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef GEARS_UTILITY_BASE64_KERNELS_HPP
+#define GEARS_UTILITY_BASE64_KERNELS_HPP
+
+#include <cstddef>
+
+// The vectorised kernels are compiled with per function target attributes
+// and picked at runtime, so they are available without any -m flags. Define
+// GEARS_BASE64_NO_SIMD to only use the portable kernels.
+#if !defined(GEARS_BASE64_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GEARS_BASE64_X86 1
+#include <immintrin.h>
+#endif
+
+namespace gears {
+namespace base64 {
+namespace detail {
+const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// value of every byte in the alphabet, -1 for the rest
+const signed char values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+enum class simd : int {
+    none,
+    ssse3,
+    avx2
+};
+
+// checked once, the function level static makes it safe to race on
+inline simd simd_support() noexcept {
+#ifdef GEARS_BASE64_X86
+    static const simd level = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? simd::avx2 :
+               __builtin_cpu_supports("ssse3") ? simd::ssse3 : simd::none;
+    }();
+    return level;
+#else
+    return simd::none;
+#endif // GEARS_BASE64_X86
+}
+
+#ifdef GEARS_BASE64_X86
+// The kernels follow Muła and Lemire, "Faster Base64 Encoding and Decoding
+// using AVX2 Instructions". Encoding spreads every 3 bytes over a 32-bit lane,
+// moves the four sextets into place with two multiplies and turns them into
+// characters by adding an offset picked with a shuffle. Decoding classifies
+// every character by its nibbles to both validate it and find the offset
+// back to its value, then packs four sextets into 3 bytes with two
+// multiply-adds. They return how much of the input they consumed, stopping
+// early at the first block with a character outside the alphabet. Stores
+// are a full register wide, so the decoders also stop once fewer than that
+// many bytes of room are left.
+
+__attribute__((target("ssse3")))
+inline __m128i encode_sextets(__m128i input) {
+    input = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i high = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    const __m128i low = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(high, low);
+
+    __m128i offsets = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    offsets = _mm_or_si128(offsets, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+    offsets = _mm_shuffle_epi8(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0), offsets);
+    return _mm_add_epi8(indices, offsets);
+}
+
+__attribute__((target("ssse3")))
+inline size_t encode_ssse3(const unsigned char* in, size_t size, char* out) {
+    size_t read = 0;
+    for(; size - read >= 16; read += 12, out += 16) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + read));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encode_sextets(input));
+    }
+    return read;
+}
+
+__attribute__((target("avx2")))
+inline size_t encode_avx2(const unsigned char* in, size_t size, char* out) {
+    const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                            10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i offsets_table = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                   '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                                   'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                   '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    size_t read = 0;
+    for(; size - read >= 28; read += 24, out += 32) {
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + read));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + read + 12));
+        __m256i input = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+        input = _mm256_shuffle_epi8(input, shuffle);
+
+        const __m256i upper = _mm256_mulhi_epu16(_mm256_and_si256(input, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+        const __m256i lower = _mm256_mullo_epi16(_mm256_and_si256(input, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(upper, lower);
+
+        __m256i offsets = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        offsets = _mm256_or_si256(offsets, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+        offsets = _mm256_shuffle_epi8(offsets_table, offsets);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_add_epi8(indices, offsets));
+    }
+    return read;
+}
+
+__attribute__((target("ssse3")))
+inline size_t decode_ssse3(const char* in, size_t size, unsigned char* out, size_t room) {
+    const __m128i lower_table = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                              0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i upper_table = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                              0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i offsets_table = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    size_t read = 0;
+    // 16 characters write 16 bytes, only 12 of them used
+    for(; size - read >= 16 && room >= 16; read += 16, out += 12, room -= 12) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + read));
+        const __m128i upper = _mm_and_si128(_mm_srli_epi32(input, 4), nibble);
+        const __m128i classes = _mm_and_si128(_mm_shuffle_epi8(lower_table, _mm_and_si128(input, nibble)),
+                                              _mm_shuffle_epi8(upper_table, upper));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(classes, _mm_setzero_si128())) != 0xffff) {
+            break;
+        }
+
+        const __m128i slashes = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+        const __m128i offsets = _mm_shuffle_epi8(offsets_table, _mm_add_epi8(slashes, upper));
+        const __m128i sextets = _mm_add_epi8(input, offsets);
+        const __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+        const __m128i packed = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                         _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+    }
+    return read;
+}
+
+__attribute__((target("avx2")))
+inline size_t decode_avx2(const char* in, size_t size, unsigned char* out, size_t room) {
+    const __m256i lower_table = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+                                                 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m256i upper_table = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                                 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i offsets_table = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                   0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    size_t read = 0;
+    for(; size - read >= 32 && room >= 32; read += 32, out += 24, room -= 24) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + read));
+        const __m256i upper = _mm256_and_si256(_mm256_srli_epi32(input, 4), nibble);
+        const __m256i classes = _mm256_and_si256(_mm256_shuffle_epi8(lower_table, _mm256_and_si256(input, nibble)),
+                                                 _mm256_shuffle_epi8(upper_table, upper));
+        if(!_mm256_testz_si256(classes, classes)) {
+            break;
+        }
+
+        const __m256i slashes = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/'));
+        const __m256i offsets = _mm256_shuffle_epi8(offsets_table, _mm256_add_epi8(slashes, upper));
+        const __m256i sextets = _mm256_add_epi8(input, offsets);
+        const __m256i pairs = _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+        __m256i packed = _mm256_shuffle_epi8(_mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000)), pack);
+        packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+    }
+    return read;
+}
+
+// Counts the characters of the alphabet in the first size / 16 * 16
+// characters, classifying them like decode_ssse3.
+__attribute__((target("ssse3")))
+inline size_t count_ssse3(const char* in, size_t size) {
+    const __m128i lower_table = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                              0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i upper_table = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                              0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    size_t result = 0;
+    for(size_t read = 0; size - read >= 16; read += 16) {
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + read));
+        const __m128i classes = _mm_and_si128(_mm_shuffle_epi8(lower_table, _mm_and_si128(input, nibble)),
+                                              _mm_shuffle_epi8(upper_table, _mm_and_si128(_mm_srli_epi32(input, 4), nibble)));
+        result += static_cast<size_t>(__builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(classes, _mm_setzero_si128()))));
+    }
+    return result;
+}
+#endif // GEARS_BASE64_X86
+
+// Encodes size bytes into (size + 2) / 3 * 4 characters, padded with '='.
+inline void encode(const unsigned char* in, size_t size, char* out) {
+    size_t read = 0;
+#ifdef GEARS_BASE64_X86
+    const simd level = simd_support();
+    if(level == simd::avx2) {
+        read = encode_avx2(in, size, out);
+    }
+    if(level != simd::none) {
+        read += encode_ssse3(in + read, size - read, out + read / 3 * 4);
+    }
+#endif // GEARS_BASE64_X86
+    out += read / 3 * 4;
+
+    for(; size - read >= 3; read += 3, out += 4) {
+        const unsigned group = (static_cast<unsigned>(in[read]) << 16) | (static_cast<unsigned>(in[read + 1]) << 8) | in[read + 2];
+        out[0] = alphabet[group >> 18];
+        out[1] = alphabet[(group >> 12) & 0x3f];
+        out[2] = alphabet[(group >> 6) & 0x3f];
+        out[3] = alphabet[group & 0x3f];
+    }
+
+    if(size - read == 1) {
+        out[0] = alphabet[in[read] >> 2];
+        out[1] = alphabet[(in[read] << 4) & 0x30];
+        out[2] = '=';
+        out[3] = '=';
+    }
+    else if(size - read == 2) {
+        out[0] = alphabet[in[read] >> 2];
+        out[1] = alphabet[((in[read] << 4) & 0x30) | (in[read + 1] >> 4)];
+        out[2] = alphabet[(in[read + 1] << 2) & 0x3c];
+        out[3] = '=';
+    }
+}
+
+// Sextets of a group of four characters that has not been completed yet.
+struct decode_state {
+    unsigned group = 0;
+    unsigned sextets = 0;
+};
+
+// Decodes size characters, skipping the ones outside the alphabet, and
+// returns the number of bytes written, which is at most (state.sextets +
+// size) / 4 * 3. Up to 3 sextets of an incomplete group are left in state.
+// Nothing is written past room bytes, which has to fit the decoded bytes.
+// The vectorised kernels only run at the start of a group of four characters
+// and leave any block with a skipped character to the loop below, resuming
+// once it is behind.
+inline size_t decode_groups(const char* in, size_t size, unsigned char* out, size_t room, decode_state& state) {
+    unsigned char* const start = out;
+    unsigned group = state.group;
+    unsigned sextets = state.sextets;
+    size_t read = 0;
+#ifdef GEARS_BASE64_X86
+    const simd level = simd_support();
+    size_t resume = 0;
+#endif // GEARS_BASE64_X86
+
+    while(read < size) {
+#ifdef GEARS_BASE64_X86
+        if(sextets == 0 && read >= resume && level != simd::none) {
+            const size_t left = room - static_cast<size_t>(out - start);
+            size_t used = level == simd::avx2 ? decode_avx2(in + read, size - read, out, left) : 0;
+            used += decode_ssse3(in + read + used, size - read - used, out + used / 4 * 3, left - used / 4 * 3);
+            read += used;
+            out += used / 4 * 3;
+            resume = read + 32;
+            if(read == size) {
+                break;
+            }
+        }
+#endif // GEARS_BASE64_X86
+
+        const signed char value = values[static_cast<unsigned char>(in[read++])];
+        if(value < 0) {
+            continue;
+        }
+
+        group = (group << 6) | static_cast<unsigned>(value);
+        if(++sextets == 4) {
+            out[0] = static_cast<unsigned char>(group >> 16);
+            out[1] = static_cast<unsigned char>(group >> 8);
+            out[2] = static_cast<unsigned char>(group);
+            out += 3;
+            group = 0;
+            sextets = 0;
+        }
+    }
+
+    state.group = group;
+    state.sextets = sextets;
+    return static_cast<size_t>(out - start);
+}
+
+// Writes the up to 2 bytes of an incomplete group and clears the state.
+inline size_t decode_tail(unsigned char* out, decode_state& state) {
+    size_t written = 0;
+    if(state.sextets == 2) {
+        out[written++] = static_cast<unsigned char>(state.group >> 4);
+    }
+    else if(state.sextets == 3) {
+        out[written++] = static_cast<unsigned char>(state.group >> 10);
+        out[written++] = static_cast<unsigned char>(state.group >> 2);
+    }
+    state = decode_state();
+    return written;
+}
+
+// Decodes size characters, with the bytes of a trailing partial group,
+// into room bytes and returns how many were written.
+inline size_t decode(const char* in, size_t size, unsigned char* out, size_t room) {
+    decode_state state;
+    const size_t written = decode_groups(in, size, out, room, state);
+    return written + decode_tail(out + written, state);
+}
+
+// Counts the characters of the alphabet, which are the ones decode doesn't skip.
+inline size_t count(const char* in, size_t size) {
+    size_t read = 0;
+    size_t result = 0;
+#ifdef GEARS_BASE64_X86
+    if(simd_support() != simd::none) {
+        read = size / 16 * 16;
+        result = count_ssse3(in, read);
+    }
+#endif // GEARS_BASE64_X86
+
+    for(; read < size; ++read) {
+        result += values[static_cast<unsigned char>(in[read])] >= 0;
+    }
+    return result;
+}
+} // detail
+} // base64
+} // gears
+
+#endif // GEARS_UTILITY_BASE64_KERNELS_HPP
@@ -0,0 +1,92 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef GEARS_UTILITY_BASE64_PARALLEL_HPP
+#define GEARS_UTILITY_BASE64_PARALLEL_HPP
+
+#include <gears/detail/parallel.hpp>
+#include <gears/utility/base64/kernels.hpp>
+#include <vector>
+
+// Smallest number of bytes that a thread of the parallel base64 functions
+// takes at a time. Inputs smaller than this are done on the calling thread.
+#ifndef GEARS_BASE64_PARALLEL_CHUNK
+#define GEARS_BASE64_PARALLEL_CHUNK 1048576
+#endif // GEARS_BASE64_PARALLEL_CHUNK
+
+namespace gears {
+namespace base64 {
+namespace detail {
+// Every 3 bytes encode to 4 characters, so chunks of a multiple of 3 bytes
+// know where their output goes.
+inline void parallel_encode(const unsigned char* in, size_t size, char* out, unsigned threads) {
+    threads = gears::detail::thread_count(threads);
+    const size_t chunks = gears::detail::chunk_count(size, GEARS_BASE64_PARALLEL_CHUNK, threads);
+    gears::detail::parallel_chunks(0, size, chunks, threads, [=](size_t begin, size_t end, size_t) {
+        encode(in + begin, end - begin, out + begin / 3 * 4);
+    }, 48);
+}
+
+// The characters of the alphabet in each chunk are counted first, and the
+// counts before a chunk tell which sextet it starts at. A chunk skips the
+// characters finishing the group of the chunk before it, decodes the groups
+// starting in it to 3 bytes per group before them and finishes its last
+// group with the characters after it, so line wrapped input splits the same
+// as anything else.
+inline size_t parallel_decode(const char* in, size_t size, unsigned char* out, unsigned threads) {
+    threads = gears::detail::thread_count(threads);
+    const size_t chunks = gears::detail::chunk_count(size, GEARS_BASE64_PARALLEL_CHUNK, threads);
+    std::vector<size_t> counts(chunks + 1);
+    gears::detail::parallel_chunks(0, size, chunks, threads, [&](size_t begin, size_t end, size_t index) {
+        counts[index + 1] = count(in + begin, end - begin);
+    }, 64);
+
+    for(size_t i = 1; i < counts.size(); ++i) {
+        counts[i] += counts[i - 1];
+    }
+
+    size_t tail = 0;
+    gears::detail::parallel_chunks(0, size, chunks, threads, [&](size_t begin, size_t end, size_t index) {
+        size_t skip = (4 - counts[index] % 4) % 4;
+        for(; begin < end && skip != 0; ++begin) {
+            skip -= values[static_cast<unsigned char>(in[begin])] >= 0;
+        }
+
+        const size_t first = (counts[index] + 3) / 4;
+        const size_t last = counts[index + 1] / 4;
+        unsigned char* position = out + first * 3;
+        decode_state state;
+        position += decode_groups(in + begin, end - begin, position, last > first ? (last - first) * 3 : 0, state);
+        for(; end < size && state.sextets != 0; ++end) {
+            position += decode_groups(in + end, 1, position, 3, state);
+        }
+
+        if(state.sextets != 0) {
+            tail = decode_tail(position, state);
+        }
+    }, 64);
+    return counts.back() / 4 * 3 + tail;
+}
+} // detail
+} // base64
+} // gears
+
+#endif // GEARS_UTILITY_BASE64_PARALLEL_HPP
@@ -0,0 +1,347 @@
+// The MIT License (MIT)
+
+// Copyright (c) 2012-2014 Danny Y., Rapptz
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef GEARS_UTILITY_BASE64_STREAM_HPP
+#define GEARS_UTILITY_BASE64_STREAM_HPP
+
+#include <gears/utility/base64/kernels.hpp>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+
+// Number of bytes the base64 stream buffers encode or decode at a time.
+// Must be a multiple of 12.
+#ifndef GEARS_BASE64_STREAM_BUFFER
+#define GEARS_BASE64_STREAM_BUFFER 12288
+#endif // GEARS_BASE64_STREAM_BUFFER
+
+namespace gears {
+namespace base64 {
+/**
+ * @ingroup utility
+ * @brief Encodes base64 incrementally.
+ * @details Encodes bytes to base64 a piece at a time. Every call to `update`
+ * encodes the complete groups of 3 bytes it can and keeps the 0 to 2 bytes
+ * left over for the next call, so the output of all the calls followed by
+ * `finish` is the same as encoding the concatenated input at once. Nothing
+ * is allocated.
+ *
+ * Example:
+ * @code
+ * base64::encoder state;
+ * char chunk[3072];
+ * char buffer[4096];
+ * while(in.read(chunk, sizeof(chunk)) || in.gcount() != 0) {
+ *     out.write(buffer, state.update(chunk, chunk + in.gcount(), buffer) - buffer);
+ * }
+ * out.write(buffer, state.finish(buffer) - buffer);
+ * @endcode
+ */
+class encoder {
+private:
+    unsigned char pending[3];
+    size_t count = 0;
+public:
+    /**
+     * @brief Returns the most characters the next `update` can write.
+     *
+     * @param bytes The number of bytes that will be passed to `update`.
+     * @return The size the output buffer needs.
+     */
+    size_t update_size(size_t bytes) const noexcept {
+        return (count + bytes) / 3 * 4;
+    }
+
+    /**
+     * @brief Encodes the next piece of the input.
+     * @details Encodes the bytes in `[first, last)` after the ones left over
+     * by the previous calls. The output must have room for
+     * `update_size(last - first)` characters.
+     *
+     * @param first The beginning of the bytes to encode.
+     * @param last The end of the bytes to encode.
+     * @param out The beginning of the output buffer.
+     * @return One past the last character written.
+     */
+    char* update(const char* first, const char* last, char* out) noexcept {
+        auto in = reinterpret_cast<const unsigned char*>(first);
+        size_t size = static_cast<size_t>(last - first);
+        if(count != 0) {
+            for(; count < 3 && size != 0; --size) {
+                pending[count++] = *in++;
+            }
+
+            if(count < 3) {
+                return out;
+            }
+
+            detail::encode(pending, 3, out);
+            out += 4;
+            count = 0;
+        }
+
+        const size_t whole = size / 3 * 3;
+        detail::encode(in, whole, out);
+        for(size_t i = whole; i < size; ++i) {
+            pending[count++] = in[i];
+        }
+        return out + whole / 3 * 4;
+    }
+
+    /**
+     * @brief Finishes the encoding.
+     * @details Writes the padded encoding of the bytes left over, at most 4
+     * characters, and resets the encoder so it can be used again.
+     *
+     * @param out The beginning of the output buffer.
+     * @return One past the last character written.
+     */
+    char* finish(char* out) noexcept {
+        if(count == 0) {
+            return out;
+        }
+
+        detail::encode(pending, count, out);
+        count = 0;
+        return out + 4;
+    }
+};
+
+/**
+ * @ingroup utility
+ * @brief Decodes base64 incrementally.
+ * @details Decodes base64 a piece at a time. Every call to `update` decodes
+ * the complete groups of 4 characters it can and keeps the 0 to 3 sextets
+ * left over for the next call, so the pieces can be split anywhere.
+ * Characters outside of the base64 alphabet are skipped like in `decode`.
+ * Nothing is allocated.
+ */
+class decoder {
+private:
+    detail::decode_state state;
+public:
+    /**
+     * @brief Returns the most bytes the next `update` can write.
+     *
+     * @param chars The number of characters that will be passed to `update`.
+     * @return The size the output buffer needs.
+     */
+    size_t update_size(size_t chars) const noexcept {
+        return (state.sextets + chars) / 4 * 3;
+    }
+
+    /**
+     * @brief Decodes the next piece of the input.
+     * @details Decodes the characters in `[first, last)` after the ones left
+     * over by the previous calls. The output must have room for
+     * `update_size(last - first)` bytes.
+     *
+     * @param first The beginning of the characters to decode.
+     * @param last The end of the characters to decode.
+     * @param out The beginning of the output buffer.
+     * @return One past the last byte written.
+     */
+    char* update(const char* first, const char* last, char* out) noexcept {
+        const size_t size = static_cast<size_t>(last - first);
+        return out + detail::decode_groups(first, size, reinterpret_cast<unsigned char*>(out), update_size(size), state);
+    }
+
+    /**
+     * @brief Finishes the decoding.
+     * @details Writes the at most 2 bytes of a group cut short by padding
+     * or the end of the input and resets the decoder so it can be used
+     * again.
+     *
+     * @param out The beginning of the output buffer.
+     * @return One past the last byte written.
+     */
+    char* finish(char* out) noexcept {
+        return out + detail::decode_tail(reinterpret_cast<unsigned char*>(out), state);
+    }
+};
+
+/**
+ * @ingroup utility
+ * @brief Stream buffer that writes base64 to an output stream.
+ * @details A stream buffer that encodes whatever is written to it and
+ * writes the base64 to another output stream, `GEARS_BASE64_STREAM_BUFFER`
+ * bytes at a time. Memory use is constant regardless of how much is
+ * written. The padding is written by `finish` or when the buffer is
+ * destroyed, and flushing the stream only writes complete groups.
+ *
+ * Only narrow character streams are supported: the buffer is a
+ * `std::streambuf` and the sink is a `std::ostream`. Wide streams have to
+ * be converted to bytes first.
+ *
+ * Example:
+ * @code
+ * std::ofstream file("attachment.b64");
+ * base64::encode_buf buffer(file);
+ * std::ostream out(&buffer);
+ * out << std::ifstream("attachment.bin", std::ios::binary).rdbuf();
+ * buffer.finish();
+ * @endcode
+ */
+class encode_buf : public std::streambuf {
+private:
+    std::ostream* sink;
+    encoder state;
+    char input[GEARS_BASE64_STREAM_BUFFER];
+    char output[GEARS_BASE64_STREAM_BUFFER / 3 * 4];
+
+    bool write(const char* first, const char* last) {
+        char* end = state.update(first, last, output);
+        sink->write(output, end - output);
+        return !sink->fail();
+    }
+
+    bool flush_input() {
+        const bool result = write(pbase(), pptr());
+        setp(input, input + sizeof(input));
+        return result;
+    }
+public:
+    explicit encode_buf(std::ostream& sink): sink(&sink) {
+        setp(input, input + sizeof(input));
+    }
+
+    encode_buf(const encode_buf&) = delete;
+    encode_buf& operator=(const encode_buf&) = delete;
+
+    ~encode_buf() {
+        try {
+            finish();
+        }
+        catch(...) {}
+    }
+
+    /**
+     * @brief Writes the rest of the encoding.
+     * @details Encodes what has been buffered, writes the padding and
+     * flushes the output stream. Anything written afterwards starts a new
+     * encoding.
+     *
+     * @return `true` if the output stream is still good, `false` otherwise.
+     */
+    bool finish() {
+        flush_input();
+        char* end = state.finish(output);
+        sink->write(output, end - output);
+        sink->flush();
+        return !sink->fail();
+    }
+protected:
+    int_type overflow(int_type ch) override {
+        if(!flush_input()) {
+            return traits_type::eof();
+        }
+
+        if(!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize count) override {
+        if(count < epptr() - pptr()) {
+            return std::streambuf::xsputn(s, count);
+        }
+
+        if(!flush_input()) {
+            return 0;
+        }
+
+        std::streamsize written = 0;
+        while(written < count) {
+            const std::streamsize n = count - written < static_cast<std::streamsize>(sizeof(input)) ? count - written : sizeof(input);
+            if(!write(s + written, s + written + n)) {
+                break;
+            }
+            written += n;
+        }
+        return written;
+    }
+
+    int sync() override {
+        return flush_input() && sink->flush() ? 0 : -1;
+    }
+};
+
+/**
+ * @ingroup utility
+ * @brief Stream buffer that reads base64 from an input stream.
+ * @details A stream buffer that reads base64 from another input stream and
+ * decodes it as it is read, `GEARS_BASE64_STREAM_BUFFER` characters at a
+ * time, so memory use is constant regardless of the size of the input.
+ * Characters outside of the base64 alphabet are skipped like in `decode`.
+ * The input stream is read until its end.
+ *
+ * Only narrow character streams are supported: the buffer is a
+ * `std::streambuf` and the source is a `std::istream`.
+ *
+ * Example:
+ * @code
+ * std::ifstream file("mail.b64");
+ * base64::decode_buf buffer(file);
+ * std::istream in(&buffer);
+ * for(auto&& line : io::lines(in)) {
+ *     std::cout << line << '\n';
+ * }
+ * @endcode
+ */
+class decode_buf : public std::streambuf {
+private:
+    std::istream* source;
+    decoder state;
+    char input[GEARS_BASE64_STREAM_BUFFER];
+    char output[GEARS_BASE64_STREAM_BUFFER / 4 * 3 + 3];
+    bool done = false;
+public:
+    explicit decode_buf(std::istream& source): source(&source) {
+        setg(output, output, output);
+    }
+
+    decode_buf(const decode_buf&) = delete;
+    decode_buf& operator=(const decode_buf&) = delete;
+protected:
+    int_type underflow() override {
+        while(gptr() == egptr()) {
+            if(done) {
+                return traits_type::eof();
+            }
+
+            source->read(input, sizeof(input));
+            const std::streamsize count = source->gcount();
+            char* end = state.update(input, input + count, output);
+            if(count < static_cast<std::streamsize>(sizeof(input))) {
+                end = state.finish(end);
+                done = true;
+            }
+            setg(output, output, end);
+        }
+        return traits_type::to_int_type(*gptr());
+    }
+};
+} // base64
+} // gears
+
+#endif // GEARS_UTILITY_BASE64_STREAM_HPP
@@ -23,6 +23,7 @@
 #include <gears/math.hpp>
 #include <tuple>
 #include <algorithm>
+#include <numeric>
 
 TEST_CASE("Higher Precision Integer", "[uintx]") {
     using namespace gears::math::literals;
@@ -50,6 +51,48 @@ TEST_CASE("Higher Precision Integer", "[uintx]") {
         REQUIRE(stuff != 0);
     }
 
+    SECTION("Large multiplication", "[uintx-mul-large]") {
+        // covers the Karatsuba, Toom-3 and NTT ranges
+        for(unsigned exponent : { 1000u, 10000u, 170000u }) {
+            gears::math::uintx<> a = 1;
+            gears::math::uintx<> base = 3;
+            for(unsigned e = exponent; e; e /= 2) {
+                if(e & 1) {
+                    a *= base;
+                }
+                base *= base;
+            }
+
+            auto square = a * a;
+            REQUIRE(square == (a + 1) * (a - 1) + 1);
+            REQUIRE((a * (a + 1)) == square + a);
+        }
+    }
+
+    SECTION("Fused operations", "[uintx-fused]") {
+        using gears::math::uintx;
+        // Horner's rule for 3x^3 + 2x^2 + x + 7 at x = 10^30
+        uintx<> x("1000000000000000000000000000000");
+        uintx<> result = 3;
+        const int coefficients[] = { 2, 1, 7 };
+        for(int c : coefficients) {
+            result = gears::math::fma(result, x, uintx<>(c));
+        }
+        REQUIRE((result == x * x * x * 3 + x * x * 2 + x + 7));
+
+        uintx<> acc = 100;
+        gears::math::add_mul(acc, x, uintx<>(5));
+        REQUIRE((acc == x * 5 + 100));
+        gears::math::sub_mul(acc, uintx<>(5), x);
+        REQUIRE(acc == 100);
+        gears::math::add_mul(acc, x, x);
+        REQUIRE((acc == x * x + 100));
+
+        uintx<64> wrap = 1;
+        gears::math::sub_mul(wrap, uintx<64>(2), uintx<64>(1));
+        REQUIRE(gears::math::uintx_cast<unsigned long long>(wrap) == 18446744073709551615ULL);
+    }
+
     SECTION("Division", "[uintx-div]") {
         auto stuff = 1927498748914987934621746728364782163748212212231_x;
         stuff /= 814371284321ULL;
@@ -59,6 +102,33 @@ TEST_CASE("Higher Precision Integer", "[uintx]") {
         REQUIRE(stuff != 0);
     }
 
+    SECTION("Divmod", "[uintx-divmod]") {
+        auto stuff = 1927498748914987934621746728364782163748212212231_x;
+        auto result = gears::math::divmod(stuff, 814371284321_x);
+        REQUIRE(result.first == 2366855003393301719774904141041689695_x);
+        REQUIRE(result.second == 27111440136_x);
+        REQUIRE_THROWS(gears::math::divmod(stuff, 0_x));
+
+        // covers both algorithm D and the Newton reciprocal
+        for(unsigned exponent : { 300u, 45000u }) {
+            gears::math::uintx<> b = 1;
+            gears::math::uintx<> base = 3;
+            for(unsigned e = exponent; e; e /= 2) {
+                if(e & 1) {
+                    b *= base;
+                }
+                base *= base;
+            }
+
+            auto a = b * (b + 7) + (b - 1);
+            auto qr = gears::math::divmod(a, b);
+            REQUIRE(qr.first == b + 7);
+            REQUIRE(qr.second == b - 1);
+            REQUIRE((a / (b + 7)) == b);
+            REQUIRE((a % (b + 7)) == b - 1);
+        }
+    }
+
     SECTION("Modulus", "[uintx-mod]") {
         auto stuff = 91984712847987981232998147123812_x;
         stuff %= 8914712412LL;
@@ -74,6 +144,264 @@ TEST_CASE("Higher Precision Integer", "[uintx]") {
         REQUIRE(i == 1234567890LL);
         auto str = gears::math::uintx_cast<std::string>(stuff);
         REQUIRE(str == "1234567890");
+
+        auto big = 340282366920938463463374607431768211457_x;
+        REQUIRE(gears::math::uintx_cast<std::string>(big) == "340282366920938463463374607431768211457");
+        REQUIRE(gears::math::uintx_cast<unsigned long long>(big) == 1ULL);
+        REQUIRE(gears::math::uintx_cast<std::string>(gears::math::uintx<>()) == "0");
+    }
+
+    SECTION("Radix conversion", "[uintx-radix]") {
+        using gears::math::uintx;
+        uintx<> x("ffffffffffffffffffffffffffffffff", 16);
+        REQUIRE(gears::math::uintx_cast<std::string>(x) == "340282366920938463463374607431768211455");
+        REQUIRE(uintx<>("zz", 36) == 1295);
+        REQUIRE(uintx<>("1010", 2) == 10);
+
+        char buffer[200];
+        auto written = gears::math::to_chars(buffer, buffer + sizeof(buffer), x, 8);
+        REQUIRE(written.ec == std::errc());
+        REQUIRE(std::string(buffer, written.ptr) == "3777777777777777777777777777777777777777777");
+        written = gears::math::to_chars(buffer, buffer + 10, x, 10);
+        REQUIRE(written.ec == std::errc::value_too_large);
+
+        uintx<> parsed;
+        const std::string str = "123456789abcdefgxyz";
+        auto read = gears::math::from_chars(str.data(), str.data() + str.size(), parsed, 16);
+        REQUIRE(read.ec == std::errc());
+        REQUIRE(read.ptr == str.data() + 15);
+        REQUIRE(parsed == uintx<>("81985529216486895"));
+        read = gears::math::from_chars(str.data() + 16, str.data() + str.size(), parsed, 16);
+        REQUIRE(read.ec == std::errc::invalid_argument);
+        uintx<8> small;
+        read = gears::math::from_chars(str.data(), str.data() + 4, small, 10);
+        REQUIRE(read.ec == std::errc::result_out_of_range);
+
+        // large enough to be split in halves
+        std::string digits(5000, '0');
+        for(size_t i = 0; i < digits.size(); ++i) {
+            digits[i] = static_cast<char>('1' + i * 7 % 9);
+        }
+        uintx<> big(digits);
+        REQUIRE(gears::math::uintx_cast<std::string>(big) == digits);
+        std::vector<char> out(digits.size());
+        written = gears::math::to_chars(out.data(), out.data() + out.size(), big, 10);
+        REQUIRE(std::string(out.data(), written.ptr) == digits);
+        written = gears::math::to_chars(out.data(), out.data() + out.size(), uintx<>(digits, 36), 36);
+        REQUIRE(std::string(out.data(), written.ptr) == digits);
+    }
+
+    SECTION("Bitwise", "[uintx-bitwise]") {
+        using gears::math::uintx;
+        uintx<> x("340282366920938463463374607431768211455"); // 2^128 - 1
+        uintx<> y("18446744073709551616"); // 2^64
+        REQUIRE((x & y) == y);
+        REQUIRE((y | 1) == uintx<>("18446744073709551617"));
+        REQUIRE((x ^ y) == (x - y));
+        REQUIRE((uintx<>(1) << 64) == y);
+        REQUIRE((x >> 100) == ((uintx<>(1) << 28) - 1));
+        REQUIRE((y >> 65) == 0);
+        REQUIRE(gears::math::popcount(x) == 128);
+        REQUIRE(gears::math::bit_length(y) == 65);
+        REQUIRE(gears::math::countr_zero(y << 37) == 101);
+        REQUIRE(gears::math::test_bit(y, 64));
+        REQUIRE(!gears::math::test_bit(y, 63));
+        REQUIRE(gears::math::countr_zero(uintx<40>(0)) == 40);
+
+        uintx<40> z = 0;
+        REQUIRE(gears::math::uintx_cast<unsigned long long>(~z) == 0xFFFFFFFFFFULL);
+        REQUIRE(gears::math::uintx_cast<unsigned long long>(uintx<40>(3) << 39) == (1ULL << 39));
+    }
+
+    SECTION("Modular", "[uintx-modular]") {
+        using gears::math::uintx;
+        const uintx<> mersenne = (uintx<>(1) << 521) - 1;
+        gears::math::modular<uintx<>> context(mersenne);
+        REQUIRE(context.pow(3, (uintx<>(1) << 520) + 12345) == uintx<>("5317293768722524343346515780643144815601808752073572181015995855596891226129122015718717050992216607914619429958849983271292217410615609895901056012762545654"));
+        REQUIRE(context.mul(uintx<>("1000000000000000000000000000007"), uintx<>("1000000000000000000000000000009")) == uintx<>("1000000000000000000000000000016000000000000000000000000000063"));
+        REQUIRE(context.sqr(mersenne + 2) == 4);
+        REQUIRE(context.reduce(mersenne * 5 + 3) == 3);
+
+        // even moduli use Barrett reduction throughout
+        REQUIRE(gears::math::mod_pow(uintx<>(123456789), uintx<>("1000000000000000000000000000001"), uintx<>(1) << 200) == uintx<>("686597485388861247373239977608796059223884196372727759359253"));
+        REQUIRE(gears::math::mod_pow(uintx<>(5), uintx<>(0), uintx<>(1)) == 0);
+        REQUIRE_THROWS(gears::math::modular<uintx<>>(0));
+    }
+
+    SECTION("Comparison", "[uintx-cmp]") {
+        auto lhs = 18446744073709551616_x;
+        auto rhs = 18446744073709551615_x;
+        REQUIRE(lhs > rhs);
+        REQUIRE(!(rhs > lhs));
+        REQUIRE(!(lhs > lhs));
+        REQUIRE(lhs >= lhs);
+        REQUIRE(rhs < lhs);
+        REQUIRE((rhs + 1) == lhs);
+        REQUIRE(--lhs == rhs);
+    }
+
+    SECTION("Bounded", "[uintx-bounded]") {
+        gears::math::uintx<64> x = 18446744073709551615ULL;
+        ++x;
+        REQUIRE(x == 0);
+        --x;
+        REQUIRE(gears::math::uintx_cast<unsigned long long>(x) == 18446744073709551615ULL);
+        gears::math::uintx<40> y = 0;
+        y -= 1;
+        REQUIRE(gears::math::uintx_cast<unsigned long long>(y) == 0xFFFFFFFFFFULL);
+        y *= y;
+        REQUIRE(gears::math::uintx_cast<unsigned long long>(y) == 1);
+    }
+
+    SECTION("Inline storage", "[uintx-inline]") {
+        using uint256 = gears::math::uintx<256>;
+        static_assert(std::is_trivially_copyable<uint256>::value, "bounded uintx should be trivially copyable");
+        constexpr uint256 constant = 18446744073709551615ULL;
+        REQUIRE(gears::math::uintx_cast<std::string>(constant) == "18446744073709551615");
+
+        uint256 power = 1;
+        gears::math::uintx<> expected = 1;
+        for(int i = 0; i < 200; ++i) {
+            power *= 3;
+            expected *= 3;
+        }
+        expected %= gears::math::uintx<>(1) + gears::math::uintx<>("115792089237316195423570985008687907853269984665640564039457584007913129639935");
+        REQUIRE(gears::math::uintx_cast<std::string>(power) == gears::math::uintx_cast<std::string>(expected));
+        REQUIRE((power / 81 * 81 + power % 81) == power);
+
+        uint256 copy = power;
+        copy += uint256(0) - power;
+        REQUIRE(copy == 0);
+    }
+
+    SECTION("Small buffer", "[uintx-small]") {
+        gears::math::uintx<> small = 12345;
+        gears::math::uintx<> large("9871239812739812731298371298379182739812738912739812");
+        auto small_copy = small;
+        auto large_copy = large;
+        std::swap(small, large);
+        REQUIRE(small == large_copy);
+        REQUIRE(large == small_copy);
+
+        auto moved = std::move(small);
+        small = std::move(large);
+        REQUIRE(small == small_copy);
+        REQUIRE(moved == large_copy);
+
+        // shrinking a heap allocated value keeps it working
+        moved %= 1000;
+        REQUIRE(moved == 812);
+        moved = small;
+        REQUIRE(moved == 12345);
+        std::vector<gears::math::uintx<>> values(100, large_copy);
+        values.resize(300, small_copy);
+        REQUIRE(std::accumulate(values.begin(), values.end(), gears::math::uintx<>(0)) == (large_copy * 100 + small_copy * 200));
+    }
+
+#ifdef __SIZEOF_INT128__
+    SECTION("64-bit limbs", "[uintx-limb64]") {
+        __extension__ typedef unsigned __int128 wide;
+        using uint64x = gears::math::uintx<static_cast<size_t>(-1), unsigned long long, wide>;
+        uint64x lhs("819374812937489172894782121212212");
+        lhs *= uint64x(7182461231831ULL);
+        REQUIRE(gears::math::uintx_cast<std::string>(lhs) == "5885127828262293680350082130474219356480320172");
+        lhs /= uint64x("819374812937489172894782121212212");
+        REQUIRE(gears::math::uintx_cast<unsigned long long>(lhs) == 7182461231831ULL);
+    }
+#endif
+}
+
+TEST_CASE("Signed Integer", "[intx]") {
+    using gears::math::intx;
+    using gears::math::intx_cast;
+
+    SECTION("Arithmetic", "[intx-arith]") {
+        intx<> a("-123456789012345678901234567890");
+        intx<> b("98765432109876543210");
+        REQUIRE(intx_cast<std::string>(a + b) == "-123456788913580246791358024680");
+        REQUIRE(intx_cast<std::string>(b - a) == "123456789111111111011111111100");
+        REQUIRE(intx_cast<std::string>(a * b) == "-12193263113702179522496570642237463801111263526900");
+        REQUIRE((a - a) == 0);
+        REQUIRE(!(a - a).is_negative());
+        REQUIRE((-a).signum() == 1);
+        REQUIRE((intx<>(5) - 7) == -2);
+        REQUIRE((intx<>(-5) + 7) == 2);
+
+        intx<> counter = 1;
+        --counter;
+        --counter;
+        REQUIRE(counter == -1);
+        ++counter;
+        REQUIRE(counter.signum() == 0);
+    }
+
+    SECTION("Division", "[intx-div]") {
+        // truncates towards zero like the built-in types
+        for(int x : { 7, -7 }) {
+            for(int y : { 2, -2 }) {
+                REQUIRE(intx_cast<int>(intx<>(x) / y) == x / y);
+                REQUIRE(intx_cast<int>(intx<>(x) % y) == x % y);
+                auto qr = gears::math::divmod(intx<>(x), intx<>(y));
+                REQUIRE(intx_cast<int>(qr.first) == x / y);
+                REQUIRE(intx_cast<int>(qr.second) == x % y);
+            }
+        }
+        REQUIRE_THROWS(intx<>(1) / 0);
+    }
+
+    SECTION("Conversion", "[intx-conv]") {
+        REQUIRE(intx_cast<long long>(intx<>(-9223372036854775807LL - 1)) == -9223372036854775807LL - 1);
+        REQUIRE(intx_cast<double>(intx<>(-3)) == -3.0);
+        REQUIRE(intx<>("+42") == 42);
+        REQUIRE(intx<>("-ff", 16) == -255);
+        REQUIRE(intx<>("-0").signum() == 0);
+        REQUIRE(intx<>(-3) < intx<>(-2));
+        REQUIRE(intx<>(-3) < intx<>(2));
+        REQUIRE(intx<>(3) > intx<>(-4));
+        REQUIRE(intx<>(gears::math::uintx<>(10), true) == -10);
+
+        constexpr intx<64> bounded = -5;
+        REQUIRE(bounded.is_negative());
+    }
+}
+
+TEST_CASE("Rational", "[rational]") {
+    using gears::math::intx;
+    using fraction = gears::math::rational<intx<>>;
+
+    SECTION("Arithmetic", "[rational-arith]") {
+        fraction sum;
+        for(int i = 1; i <= 10; ++i) {
+            sum += fraction(1, i);
+        }
+        REQUIRE(sum.numerator() == 7381);
+        REQUIRE(sum.denominator() == 2520);
+
+        fraction x(6, -8);
+        REQUIRE(x.numerator() == -3);
+        REQUIRE(x.denominator() == 4);
+        REQUIRE((x * fraction(-4, 3)) == fraction(1));
+        REQUIRE((x / x) == fraction(1));
+        REQUIRE((x - x) == fraction());
+        REQUIRE(!(x - x));
+        REQUIRE_THROWS(x / fraction());
+        REQUIRE_THROWS(x /= fraction());
+        REQUIRE(x == fraction(-3, 4));
+        fraction zero;
+        REQUIRE_THROWS(zero /= zero);
+        REQUIRE(zero == fraction());
+
+        const fraction unreduced(10, 4);
+        REQUIRE(unreduced.numerator() == 5);
+        REQUIRE(unreduced.denominator() == 2);
+        REQUIRE_THROWS(fraction(1, 0));
+    }
+
+    SECTION("Comparison", "[rational-cmp]") {
+        REQUIRE(fraction(1, 3) < fraction(1, 2));
+        REQUIRE(fraction(-1, 2) < fraction(-1, 3));
+        REQUIRE(fraction(2, 4) == fraction(1, 2));
+        REQUIRE(gears::math::rational<int>(10, 4).numerator() == 5);
     }
 }
 
@@ -81,11 +409,183 @@ TEST_CASE("Basic Algorithms", "[math-basic-algo]") {
     constexpr size_t n = 10;
     REQUIRE(gears::math::factorial(10) == 3628800);
     REQUIRE(gears::math::fibonacci(20) == 6765);
+    static_assert(gears::math::factorial(12) == 479001600, "factorial is constexpr");
+
+    SECTION("Large sequences", "[math-sequences]") {
+        using gears::math::uintx;
+        REQUIRE(gears::math::fibonacci(uintx<>(100)) == uintx<>("354224848179261915075"));
+        REQUIRE((gears::math::fibonacci(uintx<>(1001)) * gears::math::fibonacci(uintx<>(999)) - gears::math::fibonacci(uintx<>(1000)) * gears::math::fibonacci(uintx<>(1000))) == 1);
+        REQUIRE(gears::math::factorial(uintx<>(25)) == uintx<>("15511210043330985984000000"));
+
+        auto large = gears::math::factorial(uintx<>(1000));
+        REQUIRE(gears::math::uintx_cast<std::string>(large).size() == 2568);
+        REQUIRE((large / gears::math::factorial(uintx<>(998))) == 999000);
+    }
     REQUIRE(gears::math::gcd(252, 105) == 21);
+    REQUIRE(gears::math::gcd(-12, 18) == 6);
+    REQUIRE(gears::math::gcd(0u, 7u) == 7u);
+    REQUIRE(gears::math::gcd(0, 0) == 0);
+    REQUIRE(gears::math::mod_pow(4, 13, 497) == 445);
     REQUIRE(gears::math::min(1,2,3,4,5,6) == 1);
     REQUIRE(gears::math::max(5,11,9,14,19,192) == 192);
     REQUIRE((std::is_same<decltype(gears::math::max(10,1)), int>()));
     REQUIRE(n == gears::math::max(10,9,1,4));
+
+    SECTION("GCD", "[math-gcd]") {
+        using gears::math::uintx;
+        using gears::math::intx;
+        // consecutive Fibonacci numbers are the worst case for Euclid
+        uintx<> a = 0, b = 1;
+        for(int i = 0; i < 1000; ++i) {
+            b += a;
+            a = b - a;
+        }
+        REQUIRE(gears::math::gcd(a, b) == 1);
+
+        const uintx<> factor("340282366920938463463374607431768211507");
+        REQUIRE(gears::math::gcd(a * factor, b * factor) == factor);
+        REQUIRE(gears::math::gcd(a * factor, uintx<>()) == a * factor);
+        REQUIRE(gears::math::gcd(factor << 300, factor << 200) == (factor << 200));
+        REQUIRE(gears::math::gcd(intx<>(-42), intx<>(56)) == 14);
+
+        auto result = gears::math::extended_gcd(intx<>(240), intx<>(46));
+        REQUIRE(std::get<0>(result) == 2);
+        REQUIRE((std::get<1>(result) * 240 + std::get<2>(result) * 46) == 2);
+        auto small = gears::math::extended_gcd(-35, 15);
+        REQUIRE(std::get<0>(small) == 5);
+        REQUIRE((-35 * std::get<1>(small) + 15 * std::get<2>(small)) == 5);
+
+        REQUIRE(gears::math::mod_inverse(3, 7) == 5);
+        REQUIRE(gears::math::mod_inverse(1u, 1u) == 0u);
+        REQUIRE_THROWS(gears::math::mod_inverse(4, 8));
+        const uintx<> inverse = gears::math::mod_inverse(a, factor);
+        REQUIRE((a * inverse % factor) == 1);
+    }
+
+    SECTION("Roots", "[math-roots]") {
+        using gears::math::uintx;
+        REQUIRE(gears::math::isqrt(0) == 0);
+        REQUIRE(gears::math::isqrt(15) == 3);
+        REQUIRE(gears::math::isqrt(16) == 4);
+        REQUIRE(gears::math::isqrt(18446744073709551615ULL) == 4294967295ULL);
+        REQUIRE(gears::math::iroot(1000000000000000000ULL, 3) == 1000000ULL);
+        REQUIRE(gears::math::iroot(999999999999999999ULL, 3) == 999999ULL);
+
+        // (10^60 + 1)^2 is far past the precision of a double
+        const uintx<> root("1000000000000000000000000000000000000000000000000000000000001");
+        REQUIRE(gears::math::isqrt(root * root) == root);
+        REQUIRE(gears::math::isqrt(root * root - 1) == root - 1);
+        REQUIRE(gears::math::iroot(root * root * root, 3) == root);
+        REQUIRE(gears::math::iroot(uintx<>(1) << 994, 7) == (uintx<>(1) << 142));
+        REQUIRE(gears::math::iroot(uintx<>(1) << 1000, 7) == uintx<>("10099156328514439423684435017530967657253776"));
+
+        REQUIRE(gears::math::is_perfect_power(1024));
+        REQUIRE(gears::math::is_perfect_power(3125));
+        REQUIRE(!gears::math::is_perfect_power(1000001));
+        REQUIRE(!gears::math::is_perfect_power(-8));
+        REQUIRE(!gears::math::is_perfect_power(-1000001LL));
+        REQUIRE(gears::math::is_perfect_power(root * root * root * root * root));
+        REQUIRE(!gears::math::is_perfect_power(root * root + 1));
+        REQUIRE(gears::math::is_prime(uintx<>(1000000007)));
+        REQUIRE(gears::math::sum_of_divisors(uintx<>(1000000)) == 2480437);
+    }
+
+    SECTION("Primality", "[math-primality]") {
+        using gears::math::uintx;
+        REQUIRE(!gears::math::is_prime(0));
+        REQUIRE(!gears::math::is_prime(1));
+        REQUIRE(!gears::math::is_prime(-7));
+        REQUIRE(gears::math::is_prime(2));
+        REQUIRE(gears::math::is_prime(4294967291U));
+        REQUIRE(gears::math::is_prime(1000000000000000003ULL));
+        REQUIRE(gears::math::is_prime(18446744073709551557ULL));
+        REQUIRE(!gears::math::is_prime(18446744073709551615ULL));
+        REQUIRE(gears::math::mod_pow(1000000000000000003ULL, 1000000000000000002ULL, 1000000000000000003ULL) == 0);
+        REQUIRE(gears::math::mod_pow(2ULL, 1000000000000000002ULL, 1000000000000000003ULL) == 1);
+
+        // strong pseudoprimes to the bases 2, 3, 5, 7 and to 2, 7, 61
+        REQUIRE(!gears::math::is_prime(3215031751ULL));
+        REQUIRE(!gears::math::is_prime(4759123141ULL));
+        REQUIRE(!gears::math::is_prime(uintx<>(3215031751ULL)));
+
+        const unsigned long long lucas[] = { 5459, 5777, 10877, 16109, 18971, 22499, 24569, 25199, 40309, 58519 };
+        for(auto&& pseudoprime : lucas) {
+            REQUIRE(gears::math::detail::strong_lucas_probable_prime(gears::math::modular<uintx<>>(pseudoprime)));
+            REQUIRE(!gears::math::is_prime(uintx<>(pseudoprime)));
+        }
+
+        for(unsigned long long n = 0; n < 3000; ++n) {
+            bool prime = n > 1;
+            for(unsigned long long f = 2; f * f <= n; ++f) {
+                prime = prime && n % f != 0;
+            }
+            REQUIRE(gears::math::is_prime(n) == prime);
+            REQUIRE(gears::math::is_prime(uintx<>(n)) == prime);
+        }
+
+        const uintx<> m127 = (uintx<>(1) << 127) - 1;
+        const uintx<> m521 = (uintx<>(1) << 521) - 1;
+        REQUIRE(gears::math::is_prime(m127));
+        REQUIRE(gears::math::is_prime(m521));
+        REQUIRE(!gears::math::is_prime(m127 * m127));
+        REQUIRE(!gears::math::is_prime(m127 * m521));
+        REQUIRE(!gears::math::is_prime((uintx<>(1) << 128) + 1));
+    }
+
+    SECTION("Factorization", "[math-factorize]") {
+        using gears::math::uintx;
+        using factors = std::vector<std::pair<unsigned long long, size_t>>;
+        REQUIRE(gears::math::factorize(0ULL).empty());
+        REQUIRE(gears::math::factorize(1ULL).empty());
+        REQUIRE((gears::math::factorize(360ULL) == factors{ { 2, 3 }, { 3, 2 }, { 5, 1 } }));
+        REQUIRE((gears::math::factorize(18446744073709551615ULL) == factors{ { 3, 1 }, { 5, 1 }, { 17, 1 }, { 257, 1 }, { 641, 1 }, { 65537, 1 }, { 6700417, 1 } }));
+        REQUIRE((gears::math::factorize(18446743979220271189ULL) == factors{ { 4294967279ULL, 1 }, { 4294967291ULL, 1 } }));
+        REQUIRE((gears::math::factorize(18446744073709551557ULL) == factors{ { 18446744073709551557ULL, 1 } }));
+
+        const auto negative = gears::math::factorize(-1000);
+        REQUIRE(negative.size() == 2);
+        REQUIRE(negative[0] == std::make_pair(2, size_t(3)));
+        REQUIRE(negative[1] == std::make_pair(5, size_t(3)));
+
+        unsigned long long x = 88172645463325252ULL;
+        for(int i = 0; i < 200; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            unsigned long long product = 1;
+            for(auto&& factor : gears::math::factorize(x)) {
+                REQUIRE(gears::math::is_prime(factor.first));
+                for(size_t k = 0; k < factor.second; ++k) {
+                    product *= factor.first;
+                }
+            }
+            REQUIRE(product == x);
+        }
+
+        // 2^128 + 1 needs the elliptic curve method
+        const auto fermat = gears::math::factorize((uintx<>(1) << 128) + 1);
+        REQUIRE(fermat.size() == 2);
+        REQUIRE(fermat[0].first == uintx<>("59649589127497217"));
+        REQUIRE(fermat[1].first == uintx<>("5704689200685129054721"));
+
+        const auto mixed = gears::math::factorize(uintx<>(1000000007) * uintx<>(1000000007) * uintx<>(4294967291ULL) * uintx<>(720));
+        REQUIRE(mixed.size() == 5);
+        REQUIRE(mixed[0] == std::make_pair(uintx<>(2), size_t(4)));
+        REQUIRE(mixed[3] == std::make_pair(uintx<>(1000000007), size_t(2)));
+        REQUIRE(mixed[4] == std::make_pair(uintx<>(4294967291ULL), size_t(1)));
+
+        for(unsigned n = 0; n < 2000; ++n) {
+            unsigned sum = 0;
+            for(unsigned d = 1; d <= n; ++d) {
+                sum += n % d == 0 ? d : 0;
+            }
+            REQUIRE(gears::math::sum_of_divisors(n) == sum);
+        }
+        REQUIRE(gears::math::sum_of_divisors(18446743979220271189ULL) == 18446743979220271189ULL + 4294967279ULL + 4294967291ULL + 1);
+        REQUIRE(gears::math::sum_of_divisors(-12) == 0);
+        REQUIRE(gears::math::sum_of_divisors(0) == 0);
+        REQUIRE(noexcept(gears::math::sum_of_divisors(12)));
+    }
 }
 
 TEST_CASE("Generators", "[math-generator]") {
@@ -121,4 +621,176 @@ TEST_CASE("Generators", "[math-generator]") {
             }
         }
     }
+
+    SECTION("lazy primes") {
+        std::vector<unsigned long long> sieved;
+        math::primes(300000ULL, sieved);
+        auto below = math::primes_from(0, 300000);
+        std::vector<unsigned long long> lazy(below.begin(), below.end());
+        REQUIRE(lazy == sieved);
+
+        std::vector<unsigned long long> middle;
+        for(auto&& prime : math::primes_from(100000, 200000)) {
+            middle.push_back(prime);
+        }
+        auto first = std::lower_bound(sieved.begin(), sieved.end(), 100000ULL);
+        auto last = std::lower_bound(sieved.begin(), sieved.end(), 200000ULL);
+        REQUIRE(middle == std::vector<unsigned long long>(first, last));
+
+        size_t count = 0;
+        for(auto&& prime : math::primes_from(0)) {
+            if(prime >= 1000000) {
+                break;
+            }
+            ++count;
+        }
+        REQUIRE(count == 78498);
+
+        const unsigned long long expected[] = { 1000000000039ULL, 1000000000061ULL, 1000000000063ULL, 1000000000091ULL, 1000000000121ULL };
+        auto range = math::primes_from(1000000000000ULL);
+        auto it = range.begin();
+        for(auto&& prime : expected) {
+            REQUIRE(*it++ == prime);
+        }
+
+        REQUIRE(math::primes_from(24, 29).begin() == math::primes_from(24, 29).end());
+        REQUIRE(*math::primes_from(2, 3).begin() == 2);
+        REQUIRE(*math::primes_from(97).begin() == 97);
+
+        // blocks stay cache sized however far from zero the sieve starts
+        const unsigned long long far = 1000000000000000ULL;
+        math::detail::prime_sieve sieve(far, far + 400000);
+        std::vector<unsigned long long> far_primes;
+        for(unsigned long long prime = sieve(); prime != 0; prime = sieve()) {
+            REQUIRE(sieve.block_size() <= GEARS_PRIME_SIEVE_SEGMENT);
+            far_primes.push_back(prime);
+        }
+        std::vector<unsigned long long> tested;
+        for(unsigned long long n = far + 1; n < far + 400000; n += 2) {
+            if(math::is_prime(n)) {
+                tested.push_back(n);
+            }
+        }
+        REQUIRE(far_primes == tested);
+    }
+
+    SECTION("parallel primes") {
+        std::vector<unsigned> serial;
+        std::vector<unsigned> parallel;
+        math::primes(50000000u, serial);
+        math::primes(50000000u, parallel, 4);
+        REQUIRE(parallel.size() == 3001134);
+        REQUIRE(parallel == serial);
+
+        std::vector<int> few;
+        math::primes(100, few, 0);
+        REQUIRE(few == primes);
+
+        REQUIRE(math::prime_count(0) == 0);
+        REQUIRE(math::prime_count(2) == 1);
+        REQUIRE(math::prime_count(97) == 25);
+        REQUIRE(math::prime_count(1999) == 303);
+        REQUIRE(math::prime_count(100000000, 4) == 5761455);
+        REQUIRE(math::prime_count(100000000, 1) == 5761455);
+    }
+
+    SECTION("multiplicative functions") {
+        const unsigned limit = 5000;
+        std::vector<unsigned> factors;
+        std::vector<unsigned long long> phi;
+        std::vector<int> mu;
+        std::vector<unsigned long long> sigma;
+        math::smallest_prime_factors(limit, factors);
+        math::totients(limit, phi);
+        math::moebius(limit, mu);
+        math::divisor_sums(limit, sigma);
+        REQUIRE(factors.size() == limit + 1);
+        REQUIRE(phi.size() == limit + 1);
+        REQUIRE(mu.size() == limit + 1);
+        REQUIRE(sigma.size() == limit + 1);
+        REQUIRE(factors[0] == 0);
+        REQUIRE(phi[0] == 0);
+        REQUIRE(mu[0] == 0);
+        REQUIRE(sigma[0] == 0);
+
+        for(unsigned n = 1; n <= limit; ++n) {
+            unsigned long long coprime = 0;
+            for(unsigned k = 1; k <= n; ++k) {
+                coprime += math::gcd(n, k) == 1;
+            }
+
+            int moebius = 1;
+            unsigned smallest = 0;
+            for(auto&& factor : math::factorize(n)) {
+                smallest = smallest == 0 ? factor.first : smallest;
+                moebius = factor.second > 1 ? 0 : -moebius;
+            }
+
+            REQUIRE(factors[n] == (n == 1 ? 1 : smallest));
+            REQUIRE(phi[n] == coprime);
+            REQUIRE(mu[n] == moebius);
+            REQUIRE(sigma[n] == math::sum_of_divisors(static_cast<unsigned long long>(n)));
+        }
+
+        const unsigned blocks = 3 * GEARS_PRIME_SIEVE_SEGMENT + 5;
+        std::vector<unsigned long long> block_phi;
+        std::vector<long long> block_mu;
+        std::vector<unsigned long long> block_sigma;
+        math::totients(blocks, block_phi);
+        math::moebius(blocks, block_mu);
+        math::divisor_sums(blocks, block_sigma);
+        REQUIRE(block_phi.size() == blocks + 1);
+        REQUIRE(block_mu.size() == blocks + 1);
+        REQUIRE(block_sigma.size() == blocks + 1);
+        for(unsigned n = 1; n <= blocks; n += 7) {
+            unsigned long long totient = n;
+            long long moebius = 1;
+            for(auto&& factor : math::factorize(n)) {
+                totient = totient / factor.first * (factor.first - 1);
+                moebius = factor.second > 1 ? 0 : -moebius;
+            }
+
+            REQUIRE(block_phi[n] == totient);
+            REQUIRE(block_mu[n] == moebius);
+            REQUIRE(block_sigma[n] == math::sum_of_divisors(static_cast<unsigned long long>(n)));
+        }
+
+        std::vector<int> empty;
+        math::totients(0, empty);
+        REQUIRE(empty == std::vector<int>{ 0 });
+    }
+
+    SECTION("pythagorean tree") {
+        const unsigned long long perimeter = 2000;
+        std::vector<std::tuple<unsigned long long, unsigned long long, unsigned long long>> expected;
+        for(unsigned long long x = 1; x < perimeter; ++x) {
+            for(unsigned long long y = x + 1; x + y < perimeter; ++y) {
+                const unsigned long long z = math::isqrt(x * x + y * y);
+                if(z * z == x * x + y * y && x + y + z <= perimeter) {
+                    expected.emplace_back(x, y, z);
+                }
+            }
+        }
+
+        std::vector<std::tuple<unsigned long long, unsigned long long, unsigned long long>> all;
+        size_t primitive = 0;
+        for(auto&& triple : math::pythagorean_tree(perimeter, true)) {
+            unsigned long long x, y, z;
+            std::tie(x, y, z) = triple;
+            all.emplace_back(std::min(x, y), std::max(x, y), z);
+            primitive += math::gcd(x, y) == 1;
+        }
+        std::sort(all.begin(), all.end());
+        REQUIRE(all == expected);
+
+        size_t count = 0;
+        for(auto&& triple : math::pythagorean_tree(perimeter)) {
+            REQUIRE(math::gcd(std::get<0>(triple), std::get<1>(triple)) == 1);
+            REQUIRE((std::get<0>(triple) % 2) == 1);
+            ++count;
+        }
+        REQUIRE(count == primitive);
+        REQUIRE(math::pythagorean_tree(11).begin() == math::pythagorean_tree(11).end());
+        REQUIRE(*math::pythagorean_tree(12).begin() == std::make_tuple(3ULL, 4ULL, 5ULL));
+    }
 }
@@ -24,6 +24,8 @@
 #include <type_traits>
 #include <sstream>
 #include <string>
+#include <vector>
+#include <algorithm>
 
 TEST_CASE("Utility", "[utility]") {
     SECTION("array creation", "[utility-array]") {
@@ -80,6 +82,161 @@ TEST_CASE("Utility", "[utility]") {
         REQUIRE(gears::base64::decode("YW55IGNhcm5hbCBwbGVhcw==") == "any carnal pleas");
         REQUIRE(gears::base64::decode("YW55IGNhcm5hbCBwbGVhc3U=") == "any carnal pleasu");
         REQUIRE(gears::base64::decode("YW55IGNhcm5hbCBwbGVhc3VyZQ==") == "any carnal pleasure");
+
+        const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string bytes;
+        for(unsigned i = 0; i < 600; ++i) {
+            bytes += static_cast<char>((i * 7919u + i / 5) & 0xFF);
+        }
+
+        for(size_t size = 0; size <= bytes.size(); size += size < 100 ? 1 : 53) {
+            const std::string input = bytes.substr(0, size);
+            std::string expected;
+            unsigned value = 0;
+            unsigned bits = 0;
+            for(auto&& c : input) {
+                value = (value << 8) | static_cast<unsigned char>(c);
+                for(bits += 8; bits >= 6; bits -= 6) {
+                    expected += alphabet[(value >> (bits - 6)) & 0x3F];
+                }
+            }
+            if(bits != 0) {
+                expected += alphabet[(value << (6 - bits)) & 0x3F];
+            }
+            expected.append((4 - expected.size() % 4) % 4, '=');
+
+            REQUIRE(gears::base64::encode(input) == expected);
+            REQUIRE(gears::base64::decode(expected) == input);
+
+            std::string wrapped;
+            for(size_t i = 0; i < expected.size(); i += 76) {
+                wrapped += expected.substr(i, 76) + "\r\n";
+            }
+            REQUIRE(gears::base64::decode(wrapped) == input);
+        }
+
+        char buffer[1024];
+        for(size_t size = 0; size <= 300; ++size) {
+            const std::string expected = gears::base64::encode(bytes.substr(0, size));
+            REQUIRE(gears::base64::encoded_size(size) == expected.size());
+            REQUIRE(gears::base64::decoded_size(expected.data(), expected.data() + expected.size()) == size);
+
+            auto encoded = gears::base64::encode(bytes.data(), bytes.data() + size, buffer, buffer + expected.size());
+            REQUIRE(encoded.ec == std::errc());
+            REQUIRE(std::string(buffer, encoded.ptr) == expected);
+
+            auto decoded = gears::base64::decode(expected.data(), expected.data() + expected.size(), buffer, buffer + size);
+            REQUIRE(decoded.ec == std::errc());
+            REQUIRE(std::string(buffer, decoded.ptr) == bytes.substr(0, size));
+        }
+
+        const std::string hello = "SGVsbG8=";
+        REQUIRE(gears::base64::encode(bytes.data(), bytes.data() + 5, buffer, buffer + 7).ec == std::errc::value_too_large);
+        REQUIRE(gears::base64::decode(hello.data(), hello.data() + hello.size(), buffer, buffer + 4).ec == std::errc::value_too_large);
+        REQUIRE(gears::base64::decode(hello.data(), hello.data() + hello.size(), buffer, buffer + 4).ptr == buffer + 4);
+
+        std::string payload;
+        for(unsigned i = 0; i < 100000; ++i) {
+            payload += static_cast<char>((i * 2654435761u) >> 24);
+        }
+        const std::string expected = gears::base64::encode(payload);
+
+        for(size_t step : { 1, 2, 5, 64, 1000, 40000 }) {
+            gears::base64::encoder encoder;
+            gears::base64::decoder decoder;
+            std::string encoded;
+            std::string decoded;
+            std::vector<char> out;
+            for(size_t i = 0; i < payload.size(); i += step) {
+                const size_t n = std::min(step, payload.size() - i);
+                out.resize(encoder.update_size(n));
+                encoded.append(out.data(), encoder.update(payload.data() + i, payload.data() + i + n, out.data()));
+            }
+            out.resize(4);
+            encoded.append(out.data(), encoder.finish(out.data()));
+            REQUIRE(encoded == expected);
+
+            for(size_t i = 0; i < encoded.size(); i += step) {
+                const size_t n = std::min(step, encoded.size() - i);
+                out.resize(decoder.update_size(n));
+                decoded.append(out.data(), decoder.update(encoded.data() + i, encoded.data() + i + n, out.data()));
+            }
+            out.resize(2);
+            decoded.append(out.data(), decoder.finish(out.data()));
+            REQUIRE(decoded == payload);
+        }
+
+        std::ostringstream sink;
+        {
+            gears::base64::encode_buf encode_buffer(sink);
+            std::ostream out(&encode_buffer);
+            out << payload.substr(0, 10);
+            out.flush();
+            REQUIRE(sink.str() == expected.substr(0, 12));
+            out << payload.substr(10);
+        }
+        REQUIRE(sink.str() == expected);
+
+        std::string wrapped;
+        for(size_t i = 0; i < expected.size(); i += 76) {
+            wrapped += expected.substr(i, 76) + '\n';
+        }
+        std::istringstream source(wrapped);
+        gears::base64::decode_buf decode_buffer(source);
+        std::istream in(&decode_buffer);
+        std::ostringstream decoded;
+        decoded << in.rdbuf();
+        REQUIRE(decoded.str() == payload);
+
+        std::istringstream text(gears::base64::encode("first line\nsecond line"));
+        gears::base64::decode_buf lines(text);
+        std::istream reader(&lines);
+        std::string line;
+        REQUIRE(std::getline(reader, line));
+        REQUIRE(line == "first line");
+        REQUIRE(std::getline(reader, line));
+        REQUIRE(line == "second line");
+        REQUIRE(!std::getline(reader, line));
+
+        std::string large;
+        for(unsigned i = 0; i < 5000000; ++i) {
+            large += static_cast<char>((i * 2654435761u) >> 24);
+        }
+        const std::string large_encoded = gears::base64::encode(large);
+        for(unsigned threads : { 0u, 1u, 3u, 8u }) {
+            REQUIRE(gears::base64::encode(large, threads) == large_encoded);
+            REQUIRE(gears::base64::decode(large_encoded, threads) == large);
+            REQUIRE(gears::base64::encode(large.substr(0, 1000001), threads) == gears::base64::encode(large.substr(0, 1000001)));
+        }
+
+        std::string large_wrapped = large_encoded;
+        large_wrapped.insert(1500000, "\r\n");
+        REQUIRE(gears::base64::decode(large_wrapped, 4) == large);
+
+        std::string lines_wrapped;
+        for(size_t i = 0; i < large_encoded.size(); i += 76) {
+            lines_wrapped += large_encoded.substr(i, 76) + "\r\n";
+        }
+        const std::string odd = large.substr(0, 1000001);
+        std::string odd_wrapped = gears::base64::encode(odd);
+        odd_wrapped.insert(600001, std::string(2500000, '\n'));
+        for(unsigned threads : { 1u, 3u, 8u }) {
+            REQUIRE(gears::base64::decode(lines_wrapped, threads) == large);
+            REQUIRE(gears::base64::decode(odd_wrapped, threads) == odd);
+        }
+        REQUIRE(gears::base64::decode(expected, 4) == payload);
+
+        const std::string encoded = gears::base64::encode(bytes);
+        for(unsigned c = 0; c < 256; ++c) {
+            std::string noisy = encoded;
+            noisy.insert(noisy.begin() + 100, static_cast<char>(c));
+            if(alphabet.find(static_cast<char>(c)) == std::string::npos) {
+                REQUIRE(gears::base64::decode(noisy) == bytes);
+            }
+            else {
+                REQUIRE(gears::base64::decode(noisy) != bytes);
+            }
+        }
     }
 }
 